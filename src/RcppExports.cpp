@@ -34,6 +34,43 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// generate_array
+List generate_array(IntegerVector levels, int t, int d, int delta, SEXP rows, bool seed, int effort, int batch, bool quiet, SEXP progress, double interval, std::string trace);
+RcppExport SEXP _LABuilder_generate_array(SEXP levelsSEXP, SEXP tSEXP, SEXP dSEXP, SEXP deltaSEXP, SEXP rowsSEXP, SEXP seedSEXP, SEXP effortSEXP, SEXP batchSEXP, SEXP quietSEXP, SEXP progressSEXP, SEXP intervalSEXP, SEXP traceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type levels(levelsSEXP);
+    Rcpp::traits::input_parameter< int >::type t(tSEXP);
+    Rcpp::traits::input_parameter< int >::type d(dSEXP);
+    Rcpp::traits::input_parameter< int >::type delta(deltaSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type rows(rowsSEXP);
+    Rcpp::traits::input_parameter< bool >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type effort(effortSEXP);
+    Rcpp::traits::input_parameter< int >::type batch(batchSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type progress(progressSEXP);
+    Rcpp::traits::input_parameter< double >::type interval(intervalSEXP);
+    Rcpp::traits::input_parameter< std::string >::type trace(traceSEXP);
+    rcpp_result_gen = Rcpp::wrap(generate_array(levels, t, d, delta, rows, seed, effort, batch, quiet, progress, interval, trace));
+    return rcpp_result_gen;
+END_RCPP
+}
+// plan_array_r
+List plan_array_r(IntegerVector levels, int t, int d, int delta, double memory);
+RcppExport SEXP _LABuilder_plan_array_r(SEXP levelsSEXP, SEXP tSEXP, SEXP dSEXP, SEXP deltaSEXP, SEXP memorySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type levels(levelsSEXP);
+    Rcpp::traits::input_parameter< int >::type t(tSEXP);
+    Rcpp::traits::input_parameter< int >::type d(dSEXP);
+    Rcpp::traits::input_parameter< int >::type delta(deltaSEXP);
+    Rcpp::traits::input_parameter< double >::type memory(memorySEXP);
+    rcpp_result_gen = Rcpp::wrap(plan_array_r(levels, t, d, delta, memory));
+    return rcpp_result_gen;
+END_RCPP
+}
 // rcpp_hello_world
 List rcpp_hello_world();
 RcppExport SEXP _LABuilder_rcpp_hello_world() {
@@ -51,6 +88,8 @@ RcppExport SEXP _rcpp_module_boot_Array_module();
 static const R_CallMethodDef CallEntries[] = {
     {"_LABuilder_array_array2", (DL_FUNC) &_LABuilder_array_array2, 1},
     {"_LABuilder_printResults_wrapper", (DL_FUNC) &_LABuilder_printResults_wrapper, 3},
+    {"_LABuilder_generate_array", (DL_FUNC) &_LABuilder_generate_array, 12},
+    {"_LABuilder_plan_array_r", (DL_FUNC) &_LABuilder_plan_array_r, 5},
     {"_LABuilder_rcpp_hello_world", (DL_FUNC) &_LABuilder_rcpp_hello_world, 0},
     {"_rcpp_module_boot_Parser_module", (DL_FUNC) &_rcpp_module_boot_Parser_module, 0},
     {"_rcpp_module_boot_Array_module", (DL_FUNC) &_rcpp_module_boot_Array_module, 0},
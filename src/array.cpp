@@ -18,6 +18,7 @@ Last updated 12/22/2022
 */
 
 #include "array.h"
+#include "strategy.h"
 #include <iostream>
 #include <algorithm>
 #include <sys/types.h>
@@ -39,6 +40,16 @@ static void print_sets(std::vector<T*> sets);
 Interaction::Interaction(std::vector<Single*> *temp) : str_rep(this->to_string_internal(temp))
 {
     for (uint64_t i = 0; i < temp->size(); i++) singles.push_back(temp->at(i));
+    memory_note(mem_interactions,
+        sizeof(Interaction) + singles.capacity()*sizeof(Single*) + heap_bytes(str_rep));
+}
+
+/* DECONSTRUCTOR - uncounts the Interaction's memory (see memory.h)
+*/
+Interaction::~Interaction()
+{
+    memory_note(mem_interactions, -static_cast<int64_t>(sizeof(Interaction) + singles.capacity()*sizeof(Single*) +
+        heap_bytes(str_rep)));
 }
 
 /* UTILITY METHOD: to_string - gets a string representation of the Interaction
@@ -68,15 +79,25 @@ std::string Interaction::to_string_internal(std::vector<Single*> *temp) const
 /* CONSTRUCTOR - initializes the object
  * - overloaded: this version can set its fields based on a premade vector of Interaction pointers
 */
-T::T(std::vector<Interaction*> *temp) : str_rep(this->to_string_internal(temp))
+T::T(std::vector<Interaction*> *temp, bool link) : str_rep(this->to_string_internal(temp))
 {
     for (uint64_t i = 0; i < temp->size(); i++) interactions.push_back(temp->at(i));
 
     // next, give all involved Interactions a reference to this set and this set a reference to its Singles
     for (Interaction *interaction : *temp) {
-        interaction->sets.insert(this);
+        if (link) interaction->sets.insert(this);
         for (Single *single : interaction->singles) singles.push_back(single);
     }
+    memory_note(mem_sets, sizeof(T) + interactions.capacity()*sizeof(Interaction*) +
+        singles.capacity()*sizeof(Single*) + heap_bytes(str_rep));
+}
+
+/* DECONSTRUCTOR - uncounts the T set's memory (see memory.h)
+*/
+T::~T()
+{
+    memory_note(mem_sets, -static_cast<int64_t>(sizeof(T) + interactions.capacity()*sizeof(Interaction*) +
+        singles.capacity()*sizeof(Single*) + heap_bytes(str_rep)));
 }
 
 /* UTILITY METHOD: to_string - gets a string representation of the T set
@@ -120,6 +141,7 @@ Array::Array()
     is_covering = false; is_locating = false; is_detecting = false;
     dont_cares = nullptr;
     permutation = nullptr;
+    register_builtin_strategies();
 }
 
 /* CONSTRUCTOR - initializes the object
@@ -131,18 +153,26 @@ Array::Array(Parser *in) : Array::Array()
     d = in->d; t = in->t; delta = in->delta;
     num_tests = 0;  // previously in->num_rows, but generation always starts from 0 rows
     num_factors = in->num_cols;
+    rows = Row_Matrix(num_factors, *std::max_element(in->levels.begin(), in->levels.end()));
     dont_cares = new prop_mode[num_factors]{none};
     permutation = new uint16_t[num_factors];
     for (uint16_t col = 0; col < num_factors; col++) permutation[col] = col;
     debug = in->debug; v = in->v; o = in->o; p = in->p;
+    effort = in->effort;
+    stagnation_budget = in->stagnation;
+    if (!in->strategies.empty()) set_strategies(in->strategies);
+    memory_budget = in->memory_budget;
+    num_workers = in->workers;
+    if (memory_budget == 0)     // default to half of physical memory, leaving room for everything else
+        memory_budget = static_cast<uint64_t>(sysconf(_SC_PHYS_PAGES))*sysconf(_SC_PAGE_SIZE)/2;
     
     if (o != silent) printf("Building internal data structures....\n");
     if (debug == d_on) printf("==%d== max_threads is %d\n", getpid(), max_threads);
     try {
         // build all Singles, associated with an array of Factors
-        factors = new Factor*[num_factors];
+        factors = new Factor*[num_factors]();  // zeroed, so the destructor can tell what was built
         for (uint16_t i = 0; i < num_factors; i++) {
-            factors[i] = new Factor(i, in->levels.at(i), new Single*[in->levels.at(i)]);
+            factors[i] = new Factor(i, in->levels.at(i), new Single*[in->levels.at(i)]());
             for (uint16_t j = 0; j < factors[i]->level; j++) {
                 factors[i]->singles[j] = new Single(i, j);
                 singles.push_back(factors[i]->singles[j]);
@@ -152,8 +182,7 @@ Array::Array(Parser *in) : Array::Array()
         if (debug == d_on) print_singles(factors, num_factors);
 
         // build all Interactions
-        std::vector<Single*> temp_singles;
-        build_t_way_interactions(0, t, &temp_singles);
+        build_interactions();
         if (debug == d_on) print_interactions(interactions);
         total_problems += interactions.size();  // to account for all the coverage problems
         coverage_problems += interactions.size();
@@ -161,46 +190,22 @@ Array::Array(Parser *in) : Array::Array()
         if (p == c_only) return;    // no need to spend effort building Ts if they won't be used
 
         // build all Ts
-        std::vector<Interaction*> temp_interactions;
-        build_size_d_sets(0, d, &temp_interactions);
+        build_sets();
         if (debug == d_on) print_sets(sets);
-        for (T *t_set : sets) {
-            for (Single *s : t_set->singles) {
-                factors[s->factor]->l_issues += sets.size();
-                s->l_issues += sets.size();
-                total_problems += sets.size();
-            }
-            for (T *other_set : sets) {
-                if (t_set == other_set) continue;
-                t_set->location_conflicts.insert(other_set);
-            }
-        }
         total_problems += sets.size();  // to account for all the location problems
         location_problems += sets.size();
         score = total_problems; // need to update this
         if (p != prop_mode::all) return;   // can skip the following stuff if not doing detection
 
         // build all Interactions' maps of detection issues to their deltas (row difference magnitudes)
-        for (Interaction *i : interactions) {   // for all Interactions in the array
-            for (T *t_set : sets) { // for every T set this Interaction is NOT part of
-                if (i->sets.find(t_set) == i->sets.end()) {
-                    i->deltas.insert({t_set, 0});
-                    for (Single *s: i->singles) {
-                        factors[s->factor]->d_issues += delta;
-                        s->d_issues += delta;
-                        total_problems += delta;
-                        score += delta;
-                    }
-                }
-            }
-        }
+        build_deltas();
         total_problems += interactions.size();  // to account for all the detection issues
         detection_problems += interactions.size();
         score += interactions.size();   // need to update this one last time
 
     } catch (const std::bad_alloc &e) {
         printf("ERROR: not enough memory to work with given array for given arguments\n");
-        exit(1);
+        throw;  // the destructor frees what was built; main() exits, and R or a background job reports it
     }
 }
 
@@ -209,7 +214,7 @@ Array::Array(Parser *in) : Array::Array()
  *  --> intended to be used ONLY BY Array::clone()
 */
 Array::Array(uint64_t total_problems_o, uint64_t coverage_problems_o, uint64_t location_problems_o,
-    uint64_t detection_problems_o, std::vector<uint16_t*> *rows_o, uint64_t num_tests_o,
+    uint64_t detection_problems_o, const Row_Matrix *rows_o, uint64_t num_tests_o,
     uint16_t num_factors_o, Factor **factors_o, prop_mode p_o, uint16_t d_o, uint16_t t_o, uint16_t delta_o):
     Array::Array()
 {
@@ -222,11 +227,7 @@ Array::Array(uint64_t total_problems_o, uint64_t coverage_problems_o, uint64_t l
     o = silent; p = p_o;
     memory_mutex.lock();
     try {
-        for (uint16_t *row_o : *rows_o) {
-            uint16_t *row = new uint16_t[num_factors];
-            for (uint16_t col = 0; col < num_factors; col++) row[col] = row_o[col];
-            rows.push_back(row);
-        }
+        rows.assign(*rows_o);
         factors = new Factor*[num_factors];
         for (uint16_t i = 0; i < num_factors; i++) {
             factors[i] = new Factor(i, factors_o[i]->level, new Single*[factors_o[i]->level]);
@@ -236,13 +237,10 @@ Array::Array(uint64_t total_problems_o, uint64_t coverage_problems_o, uint64_t l
                 single_map.insert({factors[i]->singles[j]->to_string(), factors[i]->singles[j]});
             }
         }
-        std::vector<Single*> temp_singles;
-        build_t_way_interactions(0, t, &temp_singles);
+        enumerate_interactions();
         if (p == c_only) return;
-        std::vector<Interaction*> temp_interactions;
-        build_size_d_sets(0, d, &temp_interactions);
+        enumerate_sets();
     } catch (const std::bad_alloc &e) { // give up and free memory for now, caller can wait for other threads
-        for (uint64_t i = 0; i < num_tests; i++) delete[] rows[i];
         for (uint16_t i = 0; i < num_factors; i++) delete factors[i];
         delete[] factors;
         for (Interaction *i : interactions) delete i;
@@ -279,6 +277,7 @@ void Array::build_t_way_interactions(uint16_t start, uint16_t t_cur, std::vector
     if (t_cur == 0) {
         Interaction *new_interaction = new Interaction(singles_so_far);
         if (!new_interaction) throw std::bad_alloc();   // will unwind to original caller who should handle
+        new_interaction->index = interactions.size();
         interactions.push_back(new_interaction);
         interaction_map.insert({new_interaction->to_string(), new_interaction});    // for later accessing
         for (Single *single : new_interaction->singles) {
@@ -321,6 +320,7 @@ void Array::build_size_d_sets(uint16_t start, uint16_t d_cur, std::vector<Intera
     if (d_cur == 0) {
         T *new_set = new T(interactions_so_far);
         if (!new_set) throw std::bad_alloc();   // will unwind to original caller who should handle
+        new_set->index = sets.size();
         sets.push_back(new_set);
         t_set_map.insert({new_set->to_string(), new_set});  // for later accessing
         return;
@@ -385,7 +385,9 @@ void Array::print_stats(bool initial)
             else printf("\nArray score is currently %llu, adding row #%llu.\n", score, num_tests+1);
         } else {
             if (score == 0) {
-                printf("\nCompleted array with %llu rows.\n\n", num_tests);
+                printf("\nCompleted array with %llu rows.\n", num_tests);
+                if (v == v_on) print_memory();
+                printf("\n");
                 return;
             }
             if (o == normal) printf("\nArray score is currently %llu.\n", score);
@@ -393,17 +395,15 @@ void Array::print_stats(bool initial)
         }
     }
     if (v == v_on) {
-        uint64_t c_score = coverage_problems, l_score = location_problems, d_score = detection_problems;
-        for (Single *s : singles) {
-            c_score += s->c_issues;
-            l_score += s->l_issues;
-            d_score += s->d_issues;
-        }
+        uint64_t c_score, l_score, d_score;
+        getScore_Breakdown(&c_score, &l_score, &d_score);
         printf("\t- Current coverage score: %llu\n", c_score);
         if (p != c_only) printf("\t- Current location score: %llu\n", l_score);
         if (p == prop_mode::all) printf("\t- Current detection score: %llu\n", d_score);
         if (!initial) printf("\t- The array is now at %.4f%% completion.\n",
             static_cast<float>((total_problems - score))/total_problems*100);
+        printf("\t- Counted memory: %.2f MB (peak %.2f MB).\n", memory_live_total()/1048576.0,
+            memory_peak_total()/1048576.0);
     }
     if (o == normal) printf("Adding row #%llu.\n", num_tests+1);
     if (v == v_on) {
@@ -418,16 +418,19 @@ void Array::print_stats(bool initial)
 /* SUB METHOD: update_array - updates data structures to reflect changes caused by adding a new row
  * 
  * parameters:
- * - row: integer array representing a row that should be added to the array
+ * - row: integer array representing a row that should be added to the array, allocated with new[]
+ *  --> when kept, its values are copied into the row matrix and it is freed; otherwise the caller keeps it
  * - keep: boolean representing whether or not the changes are intended to be kept
  *  --> true by default; when false, score changes are kept but the row itself is not added
+ * - defer: boolean representing whether don't cares and the heuristic should be left for the caller
+ *  --> false by default; load_rows() sets it so that the update happens once for a whole block
  * 
  * returns:
  * - void, but after the method finishes, the array will have a new row appended to its end
 */
-void Array::update_array(uint16_t *row, bool keep)
+void Array::update_array(uint16_t *row, bool keep, bool defer)
 {
-    rows.push_back(row);
+    if (keep) rows.append(row);
     if (o == normal && keep) {
         printf("> Pushed row:\t");
         for (uint16_t i = 0; i < num_factors; i++) printf("%hu\t", row[i]);
@@ -436,7 +439,7 @@ void Array::update_array(uint16_t *row, bool keep)
     num_tests++;
 
     std::set<Interaction*> row_interactions;    // all Interactions that occur in this row
-    build_row_interactions(row, &row_interactions, 0, t, "");
+    find_row_interactions(row, &row_interactions);
     std::set<T*> row_sets;  // all T sets that occur in this row
     for (Interaction *i : row_interactions) {
         for (Single *s: i->singles) s->rows.insert(num_tests); // add the row to Singles in this Interaction
@@ -450,17 +453,18 @@ void Array::update_array(uint16_t *row, bool keep)
     update_scores(&row_interactions, &row_sets);
     if (!keep) {
         num_tests--;
-        rows.pop_back();
         return;
     }
-    update_dont_cares();
+    if (!worker_fds.empty()) broadcast_row(row);    // keeps the workers' replicas in step
+    if (!defer) update_dont_cares();
     if (heuristic_in_use != prop_mode::all) {
         std::string row_str = std::to_string(row[0]);   // string representation of the row
         for (uint16_t col = 1; col < num_factors; col++)
             row_str += ' ' + std::to_string(row[col]);
         row_scores[row_str] = delta <= 1 ? 1 : UINT64_MAX;  // will allow heuristic_all to skip some work
     }
-    update_heuristic();
+    delete[] row;   // its values are in the row matrix now
+    if (!defer) update_heuristic();
 }
 
 /* HELPER METHOD: update_scores - updates overall scores as well as for individual Singles, Interactions, Ts
@@ -475,6 +479,12 @@ void Array::update_array(uint16_t *row, bool keep)
 */
 void Array::update_scores(std::set<Interaction*> *row_interactions, std::set<T*> *row_sets)
 {
+    std::vector<uint64_t> row_set_indices;  // only needed when the deltas are spilled
+    if (delta_matrix) {
+        for (T *t_set : *row_sets) row_set_indices.push_back(t_set->index);
+        std::sort(row_set_indices.begin(), row_set_indices.end());
+    }
+
     // coverage and detection are associated with interactions
     for (Interaction *i : *row_interactions) {
         // coverage
@@ -493,6 +503,14 @@ void Array::update_scores(std::set<Interaction*> *row_interactions, std::set<T*>
         if (p == prop_mode::all) { // the following is only done if we care about detection
             if (i->is_detectable) continue; // can skip all this checking if already detectable
             i->is_detectable = true;    // about to set it back to false if anything is unsatisfied still
+            if (delta_matrix) {         // same bookkeeping, as one sweep over the Interaction's spilled row
+                update_spilled_deltas(i, &row_set_indices);
+                if (i->is_detectable) {
+                    score--;
+                    if (--detection_problems == 0) is_detecting = true;
+                }
+                continue;
+            }
             // updating detection issues for this Interaction:
             std::set<T*> other_sets = *row_sets;    // will hold all row T sets this Interaction is NOT in
             for (T *t_set : i->sets) other_sets.erase(t_set);
@@ -533,6 +551,7 @@ void Array::update_scores(std::set<Interaction*> *row_interactions, std::set<T*>
                     score -= sets.size();
                 }
                 t1->location_conflicts.clear();
+                t1->conflicts_with_all = false;
                 for (T *t2 : *row_sets) {   // for every other T set in this row,
                     if (t1 == t2 || t2->rows.size() > 1) continue;  // (skip when either of these is true)
                     t1->location_conflicts.insert(t2);  // can assume there is a location conflict
@@ -543,7 +562,7 @@ void Array::update_scores(std::set<Interaction*> *row_interactions, std::set<T*>
                     }
                 }
             } else {    // need to check if location issues were solved
-                std::set<T*> temp = t1->location_conflicts; // make a shallow copy (for mutating), and
+                auto temp = t1->location_conflicts; // make a shallow copy (for mutating), and
                 uint64_t solved = 0;
                 std::set<T*> others;
                 for (T *t2 : t1->location_conflicts)    // for every T set in the current T's conflicts,
@@ -622,6 +641,10 @@ void Array::update_dont_cares()
 */
 void Array::update_heuristic()
 {
+    if (effort >= 0) {  // adaptive scheduling was requested instead of the thresholds below
+        schedule_heuristic();
+        return;
+    }
     just_switched_heuristics = true;    // assume true until determined to be false
     float ratio = static_cast<float>(score)/total_problems;
 
@@ -668,12 +691,16 @@ void Array::update_heuristic()
         else if (heuristic_in_use == none)
             heuristic_in_use = c_only;
         else just_switched_heuristics = false;
+        if (delta_matrix && (heuristic_in_use == d_only || heuristic_in_use == prop_mode::all))
+            heuristic_in_use = l_and_d; // the heavy heuristics clone the Array, which spilled state rules out
         return;
     }
 }
 
 Array *Array::clone()
 {
+    if (delta_matrix) return nullptr;   // spilled state is far too big to copy; see update_heuristic()
+
     // instantiate with private fields, copy public fields manually
     Array *clone;
     try {
@@ -709,6 +736,7 @@ Array *Array::clone()
         T *clone_t = clone->t_set_map.at(this_t->to_string());
         clone_t->rows = this_t->rows;
         clone_t->is_locatable = this_t->is_locatable;
+        clone_t->conflicts_with_all = this_t->conflicts_with_all;
         for (T *other_t : this_t->location_conflicts) {
             T *clone_other_t = clone->t_set_map.at(other_t->to_string());
             clone_t->location_conflicts.insert(clone_other_t);
@@ -739,6 +767,46 @@ bool Array::getOut_of_Memory()
     return out_of_memory;
 }
 
+uint64_t Array::getNum_Tests()
+{
+    return num_tests;
+}
+
+uint16_t Array::getNum_Factors()
+{
+    return num_factors;
+}
+
+uint16_t Array::getLevel(uint16_t col)
+{
+    return factors[col]->level;
+}
+
+const Row_Matrix *Array::getRows()
+{
+    return &rows;
+}
+
+void Array::getScore_Breakdown(uint64_t *c_score, uint64_t *l_score, uint64_t *d_score)
+{
+    *c_score = coverage_problems; *l_score = location_problems; *d_score = detection_problems;
+    for (Single *s : singles) {
+        *c_score += s->c_issues;
+        *l_score += s->l_issues;
+        *d_score += s->d_issues;
+    }
+}
+
+void Array::set_cancel_token(std::atomic<bool> *token)
+{
+    cancel_token = token;
+}
+
+bool Array::cancelled()
+{
+    return cancel_token && cancel_token->load(std::memory_order_relaxed);
+}
+
 /* UTILITY METHOD: to_string - gets a string representation of the array
  * 
  * returns:
@@ -747,9 +815,9 @@ bool Array::getOut_of_Memory()
 std::string Array::to_string()
 {
     std::string ret = "";
-    for (uint16_t *row : rows) {
+    for (uint64_t r = 0; r < rows.size(); r++) {
         for (uint16_t i = 0; i < num_factors; i++)
-            ret += std::to_string(row[i]) + '\t';
+            ret += std::to_string(rows[r][i]) + '\t';
         ret += '\n';
     }
     return ret;
@@ -759,13 +827,15 @@ std::string Array::to_string()
 */
 Array::~Array()
 {
-    for (uint64_t i = 0; i < num_tests; i++) delete[] rows[i];
-    for (uint16_t i = 0; i < num_factors; i++) delete factors[i];
+    stop_workers();
+    for (uint16_t i = 0; factors && i < num_factors; i++) delete factors[i];
     delete[] factors;
     for (Interaction *i : interactions) delete i;
     for (T *t_set : sets) delete t_set;
     delete[] dont_cares;
     delete[] permutation;
+    delete delta_file;
+    for (Strategy *strategy : strategies) delete strategy;
 }
 
 // ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
@@ -823,7 +893,8 @@ SEXP array_array2(SEXP in) {
   Parser* parser = parser_ptr.get();
 
   try {
-    // Create the Array object
+    // Create the Array object; heuristic_all() must not fork the R session, so it scores in this process
+    parser->workers = 1;
     Rcpp::XPtr<Array> array_ptr(new Array(parser));
 
     // Return the Rcpp::XPtr of the created object
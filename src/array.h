@@ -14,9 +14,20 @@ Last updated 12/18/2022
 
 #include "parser.h"
 #include "factor.h"
+#include "spill.h"
+#include "memory.h"
+#include "rows.h"
 #include <map>
 #include <mutex>
 #include <thread>
+#include <atomic>
+#include <functional>
+#include <sys/types.h>
+
+class Shrink_State;     // working state of Array::shrink(), see shrink.h
+class Exact_Problem;    // tables read by Array::solve_exact(), see exact.h
+struct Density_Term;    // an issue heuristic_density() weighs, see density.cpp
+class Strategy;         // a named way of building rows, see strategy.h
 
 class T;    // forward declaration because Interaction and T have circular references
 
@@ -26,24 +37,28 @@ class Interaction
         // used only in verbose mode, to have some id associated with the interaction
         uint32_t id = 0;
 
+        // position in the Array's interactions vector
+        uint64_t index = 0;
+
         // the actual list of (factor, value) tuples
         std::vector<Single*> singles;
 
         // this tracks the set of tests (represented as row numbers) in which this interaction occurs;
         // this row coverage is vital to analyzing the array's properties
-        std::set<uint64_t> rows;
+        counted_set<uint64_t, mem_interaction_rows> rows;
 
         // easy lookup bool to cut down on redundant checks
         bool is_covered = false;
 
         // this tracks all the T sets in which this interaction occurs; using this, one can obtain all the
         // relevant sets when a new row with this interaction is added
-        std::set<T*> sets;  
+        counted_set<T*, mem_interactions> sets;
 
         // this tracks the set differences between the set of rows in which this Interaction occurs and the
         // sets of rows in which relevant T sets this Interaction is not part of occur; that is, this is
         // a field to map detection issues to their delta values
-        std::map<T*, uint16_t> deltas;
+        // --> left empty when the Array has spilled its deltas to disk (see Array::spilled_deltas())
+        counted_map<T*, uint16_t, mem_deltas> deltas;
 
         // easy lookup bool to cut down on redundant checks
         bool is_detectable = false;
@@ -53,6 +68,7 @@ class Interaction
 
         std::string to_string() const;      // returns a string representing all Singles in the interaction
         Interaction(std::vector<Single*> *temp);    // constructor with a premade vector of Single pointers
+        ~Interaction();                             // deconstructor
     
     private:
         std::string to_string_internal(std::vector<Single*> *temp) const;
@@ -67,6 +83,9 @@ class T
         // used only in verbose mode, to have some id associated with the T set
         uint32_t id = 0;
 
+        // position in the Array's sets vector
+        uint64_t index = 0;
+
         // for easier access to the singles themselves
         std::vector<Single*> singles;
 
@@ -75,14 +94,18 @@ class T
 
         // each interaction in a given T set has its own version of this; the ρ associated with a T is simply
         // the union of the ρ's for each interaction in that T
-        std::set<uint64_t> rows;
+        counted_set<uint64_t, mem_set_rows> rows;
 
         // this tracks all the T sets which occur in the same set of rows as this instance; when adding a
         // row to the array, each T set occurring in the row must be compared to every other T set to see
         // if their sets of rows are disjoint yet; if so, there is no longer a conflict; when the size of
         // "location_conflicts" becomes 0 while the above set, "rows", is greater than 0, this T becomes
         // locatable within the array
-        std::set<T*> location_conflicts;
+        counted_set<T*, mem_conflicts> location_conflicts;
+
+        // until a T set first occurs in a row, it conflicts with every other T set; rather than listing all
+        // of them (quadratic in the number of sets), that state is kept as this flag, with the list empty
+        bool conflicts_with_all = false;
 
         // easy lookup bool to cut down on redundant checks
         bool is_locatable = false;
@@ -91,12 +114,36 @@ class T
         const std::string str_rep;
 
         std::string to_string() const;      // returns a string representing all Interactions in the set
-        T(std::vector<Interaction*> *temp); // constructor with a premade vector of Interaction pointers
+        T(std::vector<Interaction*> *temp, bool link = true);   // constructor with a premade vector of
+                                                                // Interaction pointers; link adds this set
+                                                                // to each Interaction's sets (not thread safe)
+        ~T();                               // deconstructor
 
     private:
         std::string to_string_internal(std::vector<Interaction*> *temp) const;
 };
 
+// bookkeeping for the adaptive heuristic scheduler (see schedule.cpp); the Array keeps one per heuristic,
+// indexed by the prop_mode value that doubles as the heuristic's id
+class Heuristic_Stats
+{
+    public:
+        // rows added while this heuristic was in use
+        uint64_t rows = 0;
+
+        // total score reduction achieved by those rows
+        uint64_t reduction = 0;
+
+        // total CPU seconds spent choosing and adding those rows
+        double cpu_seconds = 0;
+
+        // exponential moving average of the fraction of the score solved per unit cost, over recent rows
+        double recent = 0;
+
+        // best value "recent" has reached so far
+        double best = 0;
+};
+
 class Array
 {
     public:
@@ -134,24 +181,48 @@ class Array
         std::vector<T*> sets;
 
         // really only needed by heuristic_all()
-        std::map<std::string, Single*> single_map;
+        counted_map<std::string, Single*, mem_maps> single_map;
 
         // used by build_row_interactions()
-        std::map<std::string, Interaction*> interaction_map;
+        counted_map<std::string, Interaction*, mem_maps> interaction_map;
 
         // really only needed by heuristic_all()
-        std::map<std::string, T*> t_set_map;
+        counted_map<std::string, T*, mem_maps> t_set_map;
 
         uint64_t getScore();
         bool getOut_of_Memory();
+        uint64_t getNum_Tests();
+        uint16_t getNum_Factors();
+        uint16_t getLevel(uint16_t col);
+        const Row_Matrix *getRows();
+        const char *getHeuristic();
+        void getScore_Breakdown(uint64_t *c_score, uint64_t *l_score, uint64_t *d_score);
         void print_stats(bool initial = false); // prints current stats such as score
         void add_row();                         // adds a row to the array based on scoring
         void add_row(uint16_t *row);            // adds a row to the array given as a parameter
+        void add_rows(uint16_t k);              // adds k rows chosen jointly, committed in one pass
+        void load_rows(std::vector<uint16_t*> *block);  // adds a block of rows with one bookkeeping pass
+        uint64_t extend_rows(const Row_Matrix *matrix, uint16_t old_cols);     // adapts old rows, adds
+        uint64_t add_seed();                    // seeds an empty array with an algebraic construction
+        uint64_t add_ipog();                    // fills an empty array with a column-wise covering array
+        bool verify();                          // rechecks all properties from scratch using row bitmaps
+        bool upgrade(prop_mode new_p, uint16_t new_d, uint16_t new_delta);  // keeps the rows, new properties
+        uint64_t shrink(double seconds);        // removes rows from a finished array while it stays finished
+        uint64_t solve_exact(double seconds);   // fills an empty array with the fewest rows possible
+        bool complete(uint16_t batch = 1, std::function<void()> after_row = nullptr);   // adds rows until done
+        void register_strategy(const std::string &name, std::function<uint16_t*()> initialize,
+            std::function<bool(uint16_t*)> refine);     // adds a way of building rows, see strategy.h
+        bool set_strategies(std::vector<std::string> names);    // chooses the strategies rows come from
+        const std::vector<Strategy*> *getStrategies();
+        void print_strategies();                // prints rows, score reduction, and CPU time per strategy
+        void print_memory();                    // prints the live and peak bytes of each structure family
+        void set_cancel_token(std::atomic<bool> *token);    // lets another thread stop generation early
+        bool cancelled();                       // whether the cancel token (if any) has been set
         std::string to_string();                // returns a string representing all rows
         Array();                                // default constructor, don't use this
         Array(Parser *in);                      // constructor with an initialized Parser object
         Array(uint64_t total_problems, uint64_t coverage_problems, uint64_t location_problems,
-            uint64_t detection_problems, std::vector<uint16_t*> *rows, uint64_t num_tests,
+            uint64_t detection_problems, const Row_Matrix *rows, uint64_t num_tests,
             uint16_t num_factors, Factor **factors, prop_mode p, uint16_t d, uint16_t t, uint16_t delta);
         ~Array();                   // deconstructor
 
@@ -168,8 +239,8 @@ class Array
         // subset of total_issues representing just detection
         uint64_t detection_problems;
         
-        // list of the rows themselves, as a vector of int arrays
-        std::vector<uint16_t*> rows;
+        // the rows themselves, in one contiguous matrix (see rows.h)
+        Row_Matrix rows;
 
         // field to track the current number of rows
         uint64_t num_tests;
@@ -184,7 +255,7 @@ class Array
         prop_mode *dont_cares;
 
         // memoized heuristic_all scores
-        std::map<std::string, uint64_t> row_scores;
+        counted_map<std::string, uint64_t, mem_row_scores> row_scores;
 
         // used to help avoid redundant checks in heuristic_all
         uint64_t min_positive_score = UINT64_MAX;
@@ -210,14 +281,77 @@ class Array
         // this keeps track of what heuristic the program is currently using
         prop_mode heuristic_in_use;
 
+        // bytes the Array's structures may take before the detection deltas are spilled to disk
+        uint64_t memory_budget;
+
+        // when spilled, every Interaction's deltas as one row of sets.size() separations, in a mapped file
+        Spill_File *delta_file = nullptr;
+        uint16_t *delta_matrix = nullptr;
+
+        // effort level for adaptive heuristic scheduling; -1 means the fixed thresholds are used instead
+        int16_t effort = -1;
+
+        // rows complete() may spend on stalls before giving up (see stagnation.cpp); 0 gives up at the first
+        uint64_t stagnation_budget = 0;
+
+        // every registered strategy, the chain rows come from (empty for the built-in choice), and the
+        // strategy that chose the last row (see strategy.cpp)
+        std::vector<Strategy*> strategies, chain;
+        Strategy *last_strategy = nullptr;
+
+        // per-heuristic rows, score reduction, and CPU time, used by schedule_heuristic()
+        Heuristic_Stats heuristic_stats[all + 1];
+
+        // rows added since heuristic_in_use last changed
+        uint64_t rows_on_heuristic = 0;
+
+        // when probing, the heuristic to return to if the probe loses, and how many probe rows remain
+        prop_mode probe_home = none;
+        uint16_t probe_rows_left = 0;
+
+        // score reduction and cost accumulated by the probe underway
+        double probe_gain = 0, probe_cost = 0;
+
+        // rows before the next heuristic gets probed even if the current one is not sagging
+        uint64_t probe_interval = 8;
+
+        // probes lost in a row; each loss makes the next probe target a more thorough heuristic
+        uint16_t probe_losses = 0;
+
+        // estimated CPU seconds per (candidate row * total problem), calibrated by heavy heuristics
+        double unit_cost = 1e-7;
+
         // needed by heuristic_all_scorer() to update scores in threads safely
         std::mutex scores_mutex;
 
         // needed by clone() to ensure threads don't get bottlenecked by memory limitations
         std::mutex memory_mutex;
 
-        // upper bound on number of threads allowed
-        const uint32_t max_threads = std::thread::hardware_concurrency();
+        // set by another thread to stop generation; checked between rows and inside the heuristics
+        std::atomic<bool> *cancel_token = nullptr;
+
+        // upper bound on number of threads allowed; a worker process lowers it to its share of the cores
+        uint32_t max_threads = std::thread::hardware_concurrency();
+
+        // processes to score heuristic_all() candidates across (see workers.cpp); 1 means this process only
+        uint16_t num_workers = 1;
+
+        // the coordinator's end of each worker's socket, and each worker's process id, once started
+        std::vector<int> worker_fds;
+        std::vector<pid_t> worker_pids;
+
+        // set when the workers could not be started or were lost, so scoring stays in this process
+        bool workers_failed = false;
+
+        // symmetry of the current rows (see symmetry.cpp): each value's class representative per column, the
+        // previous column in each column's class (UINT16_MAX for none), and whether there is any symmetry
+        std::vector<std::vector<uint16_t>> value_class;
+        std::vector<uint16_t> prev_in_class;
+        bool has_symmetry = false;
+
+        // in a worker, which share of heuristic_all_helper()'s candidates to score, and a running count
+        uint16_t partition_index = 0, partition_count = 1;
+        uint64_t candidate_ordinal = 0;
 
         // this utility method is called in the constructor to fill out the vector of all interactions
         // almost certainly needs to be recursive in order to handle arbitrary values of t
@@ -227,10 +361,41 @@ class Array
         // almost certainly needs to be recursive in order to handle arbitrary values of d
         void build_size_d_sets(uint16_t start, uint16_t d_cur, std::vector<Interaction*> *interactions_so_far);
 
+        // parallel versions of the two methods above, used by the constructor (see construct.cpp)
+        void build_interactions();
+        void build_sets();
+        std::vector<uint64_t> single_offsets();
+
+        // serial versions of the same, used by clone(); both use the fixed kernels below when they can
+        void enumerate_interactions();
+        void enumerate_sets();
+
+        // where each leading Single's run of Interactions starts, so that a row's Interactions can be found
+        // by index instead of by string key (see kernels.cpp); filled in once the interactions are built
+        std::vector<uint64_t> rank_offset, rank_pair, rank_triple;
+        void build_rank_tables();
+
+        // kernels for fixed t (2 or 3) and d (1 or 2); see the specializations declared after this class
+        template <uint16_t t_fixed> void row_interactions_fixed(uint16_t *row,
+            std::set<Interaction*> *row_interactions);
+        template <uint16_t t_fixed> void interactions_fixed(Single *lead, std::vector<Interaction*> *out);
+        template <uint16_t d_fixed> void sets_fixed(uint64_t lead, std::vector<T*> *out, bool link);
+
         // this utility method closely mimics the build_t_way_interactions() method, but uses the information
         // from a given row to fill out a set of interactions representing those that appear in the row
         void build_row_interactions(uint16_t *row, std::set<Interaction*> *row_interactions,
             uint16_t start, uint16_t t_cur, std::string key);
+        void find_row_interactions(uint16_t *row, std::set<Interaction*> *row_interactions);
+
+        uint64_t fill_columns(std::vector<uint16_t*> *block, uint16_t old_cols);
+        uint64_t relabel_levels(std::vector<uint16_t*> *block, uint16_t old_cols);
+        void column_interactions(uint16_t *row, uint16_t col, std::vector<bool> *covered,
+            std::vector<Interaction*> *gained);
+        void involving_column(uint16_t *row, uint16_t col, std::vector<Interaction*> *found);
+
+        void shuffle_permutation();
+        void pack_row(uint16_t *row, Interaction *target, std::vector<std::pair<uint64_t, Interaction*>> *ranked,
+            std::set<Interaction*> *claimed);
 
         uint16_t *initialize_row_R();                                           // randomly generated row
         uint16_t *initialize_row_R(Interaction **locked, std::vector<Interaction*> *ties = nullptr);
@@ -245,21 +410,76 @@ class Array
 
         void heuristic_l_and_d(uint16_t *row, Interaction *locked);
 
+        void density_terms(std::vector<Density_Term> *terms);
+        void heuristic_density(uint16_t *row);
         bool heuristic_all(uint16_t *row);
         bool heuristic_all(uint16_t *row, Interaction *locked);
         void heuristic_all_helper(uint16_t *row, uint16_t cur_col, std::vector<std::thread*> *threads,
             Interaction *locked = nullptr, std::map<std::string, uint64_t> *local_scores = nullptr);
         void heuristic_all_scorer(uint16_t *row, std::string row_str,
             std::map<std::string, uint64_t> *local_scores = nullptr);
+        void find_symmetries(Interaction *locked);
+        bool is_canonical(uint16_t *row);
+        void random_symmetric_row(uint16_t *row);
         
-        void update_array(uint16_t *row, bool keep = true);
+        uint64_t conflict_count(T *t_set);     // size of a T set's location conflicts, implicit or not
+        uint16_t *spilled_deltas(Interaction *i);   // an Interaction's row of the spilled deltas
+        void build_deltas();
+        bool spill_deltas();
+        void update_spilled_deltas(Interaction *i, std::vector<uint64_t> *row_set_indices);
+
+        void settle_rows();
+        uint64_t recover(uint16_t stall, uint64_t stalled, uint64_t spare);
+        bool escalate_heuristic();
+        uint16_t inject_rows();
+        void roll_back(uint64_t k);
+        void upgrade_location(std::vector<uint64_t*> *t_bits, uint64_t words);
+        void upgrade_detection(std::vector<uint64_t*> *i_bits, std::vector<uint64_t*> *t_bits, uint64_t words);
+
+        void shrink_build(Shrink_State *state);
+        int64_t shrink_shortfall(Shrink_State *state, std::vector<Interaction*> *marked_interactions,
+            std::vector<T*> *marked_sets);
+        int64_t shrink_change(Shrink_State *state, uint64_t r, uint16_t col, uint16_t value);
+        void shrink_target(Shrink_State *state, std::vector<Interaction*> *targets);
+        bool shrink_search(Shrink_State *state);
+
+        bool exact_tables(Exact_Problem *problem);
+        uint16_t exact_lower_bound(Exact_Problem *problem);
+        bool exact_rows(Exact_Problem *problem, uint16_t rows);
+
+        void update_array(uint16_t *row, bool keep = true, bool defer = false);
         void update_scores(std::set<Interaction*> *row_interactions, std::set<T*> *row_sets);
         void update_dont_cares();
         void update_heuristic();
+        void register_builtin_strategies();
+        Strategy *find_strategy(const std::string &name);
+        Strategy *choose_strategy(bool *builtin);
+        const char *strategy_unfit(Strategy *strategy);
+        void charge_strategy(Strategy *strategy, uint64_t prev_score, double cpu_seconds,
+            uint64_t num_rows = 1);
+        std::vector<prop_mode> heuristic_ladder();
+        void schedule_heuristic();
+        void record_heuristic(prop_mode h, uint64_t prev_score, double cpu_seconds, uint64_t num_rows = 1);
+        double effort_lambda();
+        double candidate_rows(prop_mode h);
+
+        bool start_workers();
+        void stop_workers();
+        void broadcast_row(uint16_t *row);
+        bool score_with_workers(uint16_t *row, Interaction *locked);
+        void worker_loop(int fd, uint16_t index);
 
         Array *clone(); // for getting a copy of this, including deep copying of object references
 
         void report_out_of_memory();    // sets out_of_memory to true with a message
 
         bool probe_memory_for_threads();    // checks if there is enough memory for heuristic_all()
-};
\ No newline at end of file
+};
+
+// the fixed kernels only exist for these values; they are defined in kernels.cpp
+template <> void Array::row_interactions_fixed<2>(uint16_t *row, std::set<Interaction*> *row_interactions);
+template <> void Array::row_interactions_fixed<3>(uint16_t *row, std::set<Interaction*> *row_interactions);
+template <> void Array::interactions_fixed<2>(Single *lead, std::vector<Interaction*> *out);
+template <> void Array::interactions_fixed<3>(Single *lead, std::vector<Interaction*> *out);
+template <> void Array::sets_fixed<1>(uint64_t lead, std::vector<T*> *out, bool link);
+template <> void Array::sets_fixed<2>(uint64_t lead, std::vector<T*> *out, bool link);
@@ -0,0 +1,198 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for the row bitmap kernels declared in bitmap.h. The vectorized versions |
+| are compiled with per-function target attributes, so this file builds with the package's default flags;   |
+| which version actually runs is decided once, the first time any kernel is called, by asking the CPU what  |
+| it supports. AVX-512 is only used when the VPOPCNTDQ extension is present, since without it the popcount  |
+| would have to be emulated anyway and AVX2 does that just as well.                                         |
+|===========================================================================================================|
+*/
+
+#include "bitmap.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BITMAP_X86
+#include <immintrin.h>
+#endif
+
+// kernel signatures, so the dispatcher can hold pointers to whichever versions fit the CPU
+typedef uint64_t (*andnot_popcount_fn)(const uint64_t *a, const uint64_t *b, uint64_t words);
+typedef void (*or_into_fn)(uint64_t *dst, const uint64_t *src, uint64_t words);
+
+// ================================v=v=v== scalar versions ==v=v=v================================ //
+
+static uint64_t andnot_popcount_scalar(const uint64_t *a, const uint64_t *b, uint64_t words)
+{
+    uint64_t count = 0;
+    for (uint64_t w = 0; w < words; w++) count += __builtin_popcountll(a[w] & ~b[w]);
+    return count;
+}
+
+static void or_into_scalar(uint64_t *dst, const uint64_t *src, uint64_t words)
+{
+    for (uint64_t w = 0; w < words; w++) dst[w] |= src[w];
+}
+
+// ================================^=^=^== scalar versions ==^=^=^================================ //
+
+#ifdef BITMAP_X86
+
+// ================================v=v=v== AVX2 versions ==v=v=v================================ //
+
+// popcount of each byte via two nibble lookups, then summed into four 64-bit lanes
+__attribute__((target("avx2")))
+static inline __m256i popcount_256(__m256i v)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_and_si256(v, low_mask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static uint64_t andnot_popcount_avx2(const uint64_t *a, const uint64_t *b, uint64_t words)
+{
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t w = 0;
+    for (; w + 4 <= words; w += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+        acc = _mm256_add_epi64(acc, popcount_256(_mm256_andnot_si256(vb, va)));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return count + andnot_popcount_scalar(a + w, b + w, words - w);
+}
+
+__attribute__((target("avx2")))
+static void or_into_avx2(uint64_t *dst, const uint64_t *src, uint64_t words)
+{
+    uint64_t w = 0;
+    for (; w + 4 <= words; w += 4) {
+        __m256i vd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + w));
+        __m256i vs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + w));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + w), _mm256_or_si256(vd, vs));
+    }
+    or_into_scalar(dst + w, src + w, words - w);
+}
+
+// ================================^=^=^== AVX2 versions ==^=^=^================================ //
+
+// ================================v=v=v== AVX-512 versions ==v=v=v================================ //
+
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static uint64_t andnot_popcount_avx512(const uint64_t *a, const uint64_t *b, uint64_t words)
+{
+    __m512i acc = _mm512_setzero_si512();
+    uint64_t w = 0;
+    for (; w + 8 <= words; w += 8) {
+        __m512i va = _mm512_loadu_si512(a + w);
+        __m512i vb = _mm512_loadu_si512(b + w);
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_andnot_epi64(0xFF, vb, va)));
+    }
+    if (w < words) {    // masked tail, so short bitmaps (the common case) never leave the vector unit
+        __mmask8 mask = static_cast<__mmask8>((1u << (words - w)) - 1);
+        __m512i va = _mm512_maskz_loadu_epi64(mask, a + w);
+        __m512i vb = _mm512_maskz_loadu_epi64(mask, b + w);
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_andnot_epi64(0xFF, vb, va)));
+    }
+    // the zero-masked forms above and this store keep the compiler's undefined registers out of the sums
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, acc);
+    uint64_t count = 0;
+    for (uint64_t lane : lanes) count += lane;
+    return count;
+}
+
+__attribute__((target("avx512f")))
+static void or_into_avx512(uint64_t *dst, const uint64_t *src, uint64_t words)
+{
+    uint64_t w = 0;
+    for (; w + 8 <= words; w += 8) {
+        __m512i vd = _mm512_loadu_si512(dst + w);
+        __m512i vs = _mm512_loadu_si512(src + w);
+        _mm512_storeu_si512(dst + w, _mm512_or_si512(vd, vs));
+    }
+    or_into_scalar(dst + w, src + w, words - w);
+}
+
+// ================================^=^=^== AVX-512 versions ==^=^=^================================ //
+
+#endif // BITMAP_X86
+
+// the kernels in use; chosen by select_kernels() the first time they are needed
+static andnot_popcount_fn andnot_popcount_impl = nullptr;
+static or_into_fn or_into_impl = nullptr;
+static const char *kernel_name = "scalar";
+
+/* HELPER METHOD: select_kernels - picks the fastest kernel versions supported by the running CPU
+ *
+ * returns:
+ * - void, but after the method finishes, the kernel pointers will be set
+*/
+static void select_kernels()
+{
+    andnot_popcount_impl = andnot_popcount_scalar;
+    or_into_impl = or_into_scalar;
+    kernel_name = "scalar";
+#ifdef BITMAP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+        andnot_popcount_impl = andnot_popcount_avx512;
+        or_into_impl = or_into_avx512;
+        kernel_name = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+        andnot_popcount_impl = andnot_popcount_avx2;
+        or_into_impl = or_into_avx2;
+        kernel_name = "avx2";
+    }
+#endif
+}
+
+uint64_t andnot_popcount(const uint64_t *a, const uint64_t *b, uint64_t words)
+{
+    if (!andnot_popcount_impl) select_kernels();
+    return andnot_popcount_impl(a, b, words);
+}
+
+void andnot_popcount_batch(const uint64_t *a, const uint64_t *const *bs, uint64_t count, uint64_t words,
+    uint64_t *out)
+{
+    if (!andnot_popcount_impl) select_kernels();
+    andnot_popcount_fn kernel = andnot_popcount_impl;   // hoisted so the loop is a plain indirect call
+    if (words == 1) {   // one word covers up to 64 rows, by far the most common size; skip the dispatch
+        for (uint64_t i = 0; i < count; i++) out[i] = __builtin_popcountll(a[0] & ~bs[i][0]);
+        return;
+    }
+    for (uint64_t i = 0; i < count; i++) out[i] = kernel(a, bs[i], words);
+}
+
+void or_into(uint64_t *dst, const uint64_t *src, uint64_t words)
+{
+    if (!or_into_impl) select_kernels();
+    or_into_impl(dst, src, words);
+}
+
+uint64_t bitmap_signature(const uint64_t *bits, uint64_t words)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ words;
+    for (uint64_t w = 0; w < words; w++) {  // splitmix64 finalizer over each word, folded in order
+        uint64_t z = bits[w] + 0x9e3779b97f4a7c15ULL*(w + 1);
+        z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+        h = (h ^ (z ^ (z >> 31)))*0x100000001b3ULL;
+    }
+    return h;
+}
+
+const char *bitmap_kernel_name()
+{
+    if (!andnot_popcount_impl) select_kernels();
+    return kernel_name;
+}
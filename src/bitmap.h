@@ -0,0 +1,40 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains kernels over row bitmaps, where bit r of a bitmap is set when the thing it belongs  |
+| to (an Interaction or a T set) occurs in row r of the array. Detection needs |ρ(I) \ ρ(T)| for a huge    |
+| number of (Interaction, T) pairs, which is an AND-NOT followed by a popcount; location needs equality     |
+| tests between T row sets, which are first screened by comparing 64-bit signatures. Each kernel has a     |
+| portable scalar version plus AVX2 and AVX-512 versions on x86-64; the fastest one the CPU supports is     |
+| picked at runtime, so no special compiler flags are needed. The batch entry points take one bitmap and   |
+| compare it against many others, which is the shape of the inner loops in verification.                  |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef BITMAP
+#define BITMAP
+
+#include <stdint.h>
+
+// number of 64-bit words needed for a bitmap over the given number of rows
+inline uint64_t bitmap_words(uint64_t num_rows) { return (num_rows + 63)/64; }
+
+// |a \ b|, the number of bits set in a but not in b
+uint64_t andnot_popcount(const uint64_t *a, const uint64_t *b, uint64_t words);
+
+// out[i] = |a \ bs[i]| for every i < count
+void andnot_popcount_batch(const uint64_t *a, const uint64_t *const *bs, uint64_t count, uint64_t words,
+    uint64_t *out);
+
+// dst |= src
+void or_into(uint64_t *dst, const uint64_t *src, uint64_t words);
+
+// 64-bit signature of a bitmap; equal bitmaps always have equal signatures
+uint64_t bitmap_signature(const uint64_t *bits, uint64_t words);
+
+// name of the kernel set chosen for this CPU ("avx512", "avx2", or "scalar")
+const char *bitmap_kernel_name();
+
+#endif // BITMAP
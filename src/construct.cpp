@@ -0,0 +1,303 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds the parallel construction of the problem universe: the Interactions, the T sets,   |
+| and the detection deltas. Interactions are split up by their leading Single and T sets by their leading  |
+| Interaction; threads take pieces off a shared counter, build each into its own buffer, and the pieces are |
+| then appended in order, so the vectors come out exactly as the serial recursion would have built them.   |
+| Nothing shared is written while the threads run: issue counts are kept per thread and summed at the end, |
+| and each Interaction's list of T sets is filled by the one thread that owns that Interaction's index.    |
+| The recursive builders in array.cpp are still used by clone(), which already runs inside other threads.  |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// Interactions per piece when laying out the deltas; small enough to balance, large enough to be worth a grab
+#define DELTA_PIECE 64
+
+/* HELPER METHOD: run_pieces - runs work on every piece, spread over a number of threads
+ * - pieces are handed out in order from a shared counter, so uneven pieces still balance out
+ * - a bad_alloc in any thread stops the others from starting new pieces, and is rethrown once all have joined
+ *
+ * parameters:
+ * - count: number of pieces
+ * - threads: most threads to use; the calling thread counts as one unless alongside is given
+ * - work: called with (piece, thread) for every piece; thread is below the number of threads used
+ * - alongside: optional serial task for the calling thread to run while the others work
+ *
+ * returns:
+ * - number of threads that were used, so the caller knows how many per-thread buffers hold results
+*/
+static uint32_t run_pieces(uint64_t count, uint32_t threads,
+    const std::function<void(uint64_t, uint32_t)> &work, const std::function<void()> &alongside = nullptr)
+{
+    if (threads == 0) threads = 1;
+    if (threads > count) threads = count > 0 ? count : 1;
+    std::atomic<uint64_t> next(0);
+    std::atomic<bool> failed(false);
+    auto body = [&](uint32_t thread) {
+        try {
+            for (uint64_t piece = next++; piece < count && !failed; piece = next++) work(piece, thread);
+        } catch (const std::bad_alloc &e) {
+            failed = true;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (uint32_t thread = alongside ? 0 : 1; thread < threads; thread++) pool.emplace_back(body, thread);
+    if (alongside) alongside();
+    else body(0);
+    for (std::thread &cur_thread : pool) cur_thread.join();
+    if (failed) throw std::bad_alloc();
+    return threads;
+}
+
+/* HELPER METHOD: collect_interactions - the recursion of build_t_way_interactions(), into a buffer
+ * - used for the values of t that have no fixed kernel (see kernels.cpp)
+ *
+ * parameters:
+ * - factors: the Array's factors
+ * - num_factors: number of factors
+ * - start: left side of factors array at which to begin the outer for loop
+ * - t_cur: Singles still to be added to the combination
+ * - singles_so_far: the combination so far
+ * - out: where new Interactions go, in the order the serial recursion would have made them
+ *
+ * returns:
+ * - void, but after the method finishes, out will hold every Interaction extending singles_so_far
+*/
+static void collect_interactions(Factor **factors, uint16_t num_factors, uint16_t start, uint16_t t_cur,
+    std::vector<Single*> *singles_so_far, std::vector<Interaction*> *out)
+{
+    if (t_cur == 0) {
+        out->push_back(new Interaction(singles_so_far));
+        return;
+    }
+    uint16_t end = num_factors - t_cur + 1;
+    for (uint16_t col = start; col < end; col++) {
+        for (uint16_t level = 0; level < factors[col]->level; level++) {
+            singles_so_far->push_back(factors[col]->singles[level]);
+            collect_interactions(factors, num_factors, col + 1, t_cur - 1, singles_so_far, out);
+            singles_so_far->pop_back();
+        }
+    }
+}
+
+/* HELPER METHOD: collect_sets - the recursion of build_size_d_sets(), into a buffer
+ * - used for the values of d that have no fixed kernel (see kernels.cpp)
+ * - the T sets made are not yet linked into their Interactions' lists of sets
+ *
+ * parameters:
+ * - interactions: the Array's interactions
+ * - start: index in interactions at which to begin the for loop
+ * - d_cur: Interactions still to be added to the combination
+ * - interactions_so_far: the combination so far
+ * - out: where new T sets go, in the order the serial recursion would have made them
+ *
+ * returns:
+ * - void, but after the method finishes, out will hold every T set extending interactions_so_far
+*/
+static void collect_sets(std::vector<Interaction*> *interactions, uint64_t start, uint16_t d_cur,
+    std::vector<Interaction*> *interactions_so_far, std::vector<T*> *out)
+{
+    if (d_cur == 0) {
+        out->push_back(new T(interactions_so_far, false));
+        return;
+    }
+    for (uint64_t i = start; i + d_cur <= interactions->size(); i++) {
+        interactions_so_far->push_back(interactions->at(i));
+        collect_sets(interactions, i + 1, d_cur - 1, interactions_so_far, out);
+        interactions_so_far->pop_back();
+    }
+}
+
+/* HELPER METHOD: single_offsets - gives every Single a position in a flat array of per-Single counters
+ *
+ * returns:
+ * - the first position of each factor's Singles; the last entry is the total number of Singles
+*/
+std::vector<uint64_t> Array::single_offsets()
+{
+    std::vector<uint64_t> offsets(num_factors + 1, 0);
+    for (uint16_t col = 0; col < num_factors; col++) offsets[col + 1] = offsets[col] + factors[col]->level;
+    return offsets;
+}
+
+/* HELPER METHOD: build_interactions - initializes the interactions vector, using up to max_threads threads
+ * - the result is the same as build_t_way_interactions(0, t, ...), coverage issues included, and the rank
+ *   tables are built as well
+ * - the factors array must be initialized before calling this method, and it should only be called once
+ *
+ * returns:
+ * - void, but after the method finishes, the interactions vector and map will be initialized
+*/
+void Array::build_interactions()
+{
+    std::vector<Single*> leads;     // one piece per leading Single
+    for (uint16_t col = 0; col + t <= num_factors; col++)
+        for (uint16_t level = 0; level < factors[col]->level; level++)
+            leads.push_back(factors[col]->singles[level]);
+    std::vector<std::vector<Interaction*>> pieces(leads.size());
+    std::vector<uint64_t> offsets = single_offsets();
+    std::vector<std::vector<uint64_t>> counts(max_threads > 0 ? max_threads : 1);
+    uint32_t used = run_pieces(leads.size(), max_threads, [&](uint64_t piece, uint32_t thread) {
+        if (t == 2) interactions_fixed<2>(leads[piece], &pieces[piece]);
+        else if (t == 3) interactions_fixed<3>(leads[piece], &pieces[piece]);
+        else {
+            std::vector<Single*> singles_so_far(1, leads[piece]);
+            collect_interactions(factors, num_factors, leads[piece]->factor + 1, t - 1, &singles_so_far,
+                &pieces[piece]);
+        }
+        std::vector<uint64_t> &count = counts[thread];
+        if (count.empty()) count.resize(offsets.back(), 0);
+        for (Interaction *i : pieces[piece])
+            for (Single *s : i->singles) count[offsets[s->factor] + s->value]++;
+    });
+
+    for (std::vector<Interaction*> &piece : pieces) {
+        for (Interaction *new_interaction : piece) {
+            new_interaction->index = interactions.size();
+            interactions.push_back(new_interaction);
+            interaction_map.insert({new_interaction->to_string(), new_interaction});    // for later accessing
+        }
+        std::vector<Interaction*>().swap(piece);
+    }
+    for (uint32_t thread = 0; thread < used; thread++) {
+        if (counts[thread].empty()) continue;   // this thread never got a piece
+        for (uint16_t col = 0; col < num_factors; col++)
+            for (uint16_t level = 0; level < factors[col]->level; level++) {
+                uint64_t issues = counts[thread][offsets[col] + level];
+                factors[col]->c_issues += issues;
+                factors[col]->singles[level]->c_issues += issues;
+                total_problems += issues;
+                score += issues;
+            }
+    }
+    build_rank_tables();
+}
+
+/* HELPER METHOD: build_sets - initializes the sets vector, using up to max_threads threads
+ * - the result is the same as build_size_d_sets(0, d, ...), plus the location issues the constructor adds
+ *   for every T set, each of which starts out conflicting with all others
+ * - the interactions vector must be initialized before calling this method
+ *
+ * returns:
+ * - void, but after the method finishes, the sets vector and map will be initialized, and every
+ *   Interaction will list the T sets it is part of
+*/
+void Array::build_sets()
+{
+    uint64_t leads = interactions.size() >= d ? interactions.size() - d + 1 : 0;  // one piece per leading one
+    std::vector<std::vector<T*>> pieces(leads);
+    std::vector<uint64_t> offsets = single_offsets();
+    std::vector<std::vector<uint64_t>> counts(max_threads > 0 ? max_threads : 1);
+    uint32_t used = run_pieces(leads, max_threads, [&](uint64_t piece, uint32_t thread) {
+        if (d == 1) sets_fixed<1>(piece, &pieces[piece], false);
+        else if (d == 2) sets_fixed<2>(piece, &pieces[piece], false);
+        else {
+            std::vector<Interaction*> interactions_so_far(1, interactions[piece]);
+            collect_sets(&interactions, piece + 1, d - 1, &interactions_so_far, &pieces[piece]);
+        }
+        std::vector<uint64_t> &count = counts[thread];
+        if (count.empty()) count.resize(offsets.back(), 0);
+        for (T *t_set : pieces[piece])
+            for (Single *s : t_set->singles) count[offsets[s->factor] + s->value]++;
+    });
+
+    for (std::vector<T*> &piece : pieces) {
+        for (T *new_set : piece) {
+            new_set->index = sets.size();
+            new_set->conflicts_with_all = true;     // conflicts with every other set until it first occurs
+            sets.push_back(new_set);
+        }
+        std::vector<T*>().swap(piece);
+    }
+
+    // each thread reads its own range of T sets once, sorting the links by the thread that owns each
+    // Interaction, while this one fills the map; then each thread inserts the links into its own Interactions
+    uint32_t linkers = max_threads > 1 ? max_threads - 1 : 1;
+    if (linkers > interactions.size()) linkers = interactions.size() > 0 ? interactions.size() : 1;
+    std::vector<std::vector<std::vector<std::pair<Interaction*, T*>>>> links(linkers,
+        std::vector<std::vector<std::pair<Interaction*, T*>>>(linkers));
+    run_pieces(linkers, linkers, [&](uint64_t piece, uint32_t) {
+        uint64_t low = sets.size()*piece/linkers, high = sets.size()*(piece + 1)/linkers;
+        for (uint64_t idx = low; idx < high; idx++)
+            for (Interaction *i : sets[idx]->interactions)
+                links[piece][i->index*linkers/interactions.size()].push_back({i, sets[idx]});
+    }, [&]() {
+        for (T *t_set : sets) t_set_map.insert({t_set->to_string(), t_set});  // for later accessing
+    });
+    run_pieces(linkers, linkers, [&](uint64_t piece, uint32_t) {
+        for (uint32_t from = 0; from < linkers; from++) {
+            for (std::pair<Interaction*, T*> &link : links[from][piece]) link.first->sets.insert(link.second);
+            std::vector<std::pair<Interaction*, T*>>().swap(links[from][piece]);
+        }
+    });
+
+    for (uint32_t thread = 0; thread < used; thread++) {
+        if (counts[thread].empty()) continue;
+        for (uint16_t col = 0; col < num_factors; col++)
+            for (uint16_t level = 0; level < factors[col]->level; level++) {
+                uint64_t issues = counts[thread][offsets[col] + level]*sets.size();
+                factors[col]->l_issues += issues;
+                factors[col]->singles[level]->l_issues += issues;
+                total_problems += issues;
+            }
+    }
+}
+
+/* HELPER METHOD: build_deltas - sets up every Interaction's detection issues, all with a separation of 0
+ * - called by the constructor after the T sets are built, and by upgrade()
+ * - if the deltas maps would not fit in the memory budget, they are spilled to disk instead
+ * - every Interaction's deltas are its own, so pieces of the interactions vector are laid out in parallel
+ *
+ * returns:
+ * - void, but after the method finishes, the detection issues and their scores will be in place
+*/
+void Array::build_deltas()
+{
+    // each T set holds d distinct Interactions, so that many (Interaction, T) pairs are not issues
+    uint64_t tracked = interactions.size()*sets.size() - static_cast<uint64_t>(d)*sets.size();
+    bool spilled = tracked*DELTA_MAP_NODE_BYTES > memory_budget && spill_deltas();
+    std::vector<uint64_t> offsets = single_offsets();
+    std::vector<std::vector<uint64_t>> counts(max_threads > 0 ? max_threads : 1);
+    uint64_t num_pieces = (interactions.size() + DELTA_PIECE - 1)/DELTA_PIECE;
+    uint32_t used = run_pieces(num_pieces, max_threads, [&](uint64_t piece, uint32_t thread) {
+        std::vector<uint64_t> &count = counts[thread];
+        if (count.empty()) count.resize(offsets.back(), 0);
+        uint64_t end = std::min<uint64_t>((piece + 1)*DELTA_PIECE, interactions.size());
+        for (uint64_t idx = piece*DELTA_PIECE; idx < end; idx++) {
+            Interaction *i = interactions[idx];
+            uint64_t issues = sets.size() - i->sets.size(); // one for every T set it is NOT part of
+            if (spilled) {  // the file starts out zeroed, so only the untracked entries need writing
+                uint16_t *separations = spilled_deltas(i);
+                for (T *t_set : i->sets) separations[t_set->index] = DELTA_NOT_TRACKED;
+            } else {
+                for (T *t_set : sets)
+                    if (i->sets.find(t_set) == i->sets.end()) i->deltas.insert({t_set, 0});
+            }
+            for (Single *s : i->singles) count[offsets[s->factor] + s->value] += issues;
+        }
+    });
+
+    for (uint32_t thread = 0; thread < used; thread++) {
+        if (counts[thread].empty()) continue;
+        for (uint16_t col = 0; col < num_factors; col++)
+            for (uint16_t level = 0; level < factors[col]->level; level++) {
+                uint64_t issues = delta*counts[thread][offsets[col] + level];
+                factors[col]->d_issues += issues;
+                factors[col]->singles[level]->d_issues += issues;
+                total_problems += issues;
+                score += issues;
+            }
+    }
+}
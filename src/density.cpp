@@ -0,0 +1,230 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds the density engine, a deterministic alternative to the randomized heuristics in    |
+| heuristics.cpp. A row is built one factor at a time, each factor getting the value with the largest       |
+| expected number of issues the row would solve, over random completions of the factors not yet fixed. The |
+| expectation over the choices for a factor is their average, so the best choice never lowers it, and the  |
+| finished row solves at least as many issues as a row chosen at random would be expected to.              |
+|   The issues are read off the current state, each as a Density_Term: an Interaction not covered yet needs |
+| to occur; two T sets in conflict need a row with exactly one of them; and an Interaction separated from a |
+| T set by fewer than δ rows needs a row with it but not the T set. Each of these is a chance that some    |
+| Interactions occur and others do not, which inclusion-exclusion turns into chances that whole lists of   |
+| Interactions occur together. Those are easy: the list cannot occur if two of its Singles disagree or one |
+| disagrees with a fixed factor, and otherwise occurs with chance 1/level for each factor still free.     |
+|   Early on, there can be far too many conflicts and separations to list; then each unlocatable T set and  |
+| each undetectable Interaction just counts as needing to occur, much as the Single counters treat them.   |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// most conflicts and separations listed one by one; past this, the simpler terms are used instead
+#define DENSITY_MAX_TERMS 200000
+
+// most Interactions a term may involve; inclusion-exclusion is exponential in this
+#define DENSITY_MAX_UNION 8
+
+// the kinds of issue a Density_Term can stand for
+#define DENSITY_OCCUR 0     // some Interaction in a needs to occur
+#define DENSITY_SEPARATE 1  // exactly one of a T set (a) and a T set (b) needs to occur
+#define DENSITY_EXCLUDE 2   // an Interaction (a) needs to occur without any of a T set (b)
+
+// one issue a new row could help solve
+struct Density_Term
+{
+    uint8_t kind = DENSITY_OCCUR;
+    std::vector<Interaction*> a, b;
+};
+
+// method forward declarations
+static double chance_all(std::vector<Interaction*> *list, uint64_t mask, uint16_t *row,
+    std::vector<bool> *fixed, Factor **factors);
+static double chance_any(std::vector<Interaction*> *list, uint16_t *row, std::vector<bool> *fixed,
+    Factor **factors);
+static double term_chance(Density_Term *term, uint16_t *row, std::vector<bool> *fixed, Factor **factors);
+
+/* HELPER METHOD: density_terms - lists the issues a new row could help solve
+ *
+ * parameters:
+ * - terms: vector to fill
+ *
+ * returns:
+ * - void, but after the method finishes, terms will hold every issue, in one form or the other
+*/
+void Array::density_terms(std::vector<Density_Term> *terms)
+{
+    for (Interaction *i : interactions) {
+        if (i->is_covered) continue;
+        terms->push_back(Density_Term());
+        terms->back().a.push_back(i);
+    }
+    if (p == c_only) return;
+
+    // count the pairwise issues first, to know whether listing them is affordable
+    uint64_t pairs = 0;
+    for (T *t_set : sets)
+        if (!t_set->is_locatable && !t_set->conflicts_with_all) pairs += t_set->location_conflicts.size();
+    if (p == prop_mode::all) {
+        if (delta_matrix) pairs = DENSITY_MAX_TERMS + 1;  // spilled deltas are too slow to list
+        else for (Interaction *i : interactions) {
+            if (i->is_detectable) continue;
+            for (auto &kv : i->deltas) pairs += kv.second < delta;
+        }
+    }
+    bool listed = pairs <= DENSITY_MAX_TERMS && 2*d <= DENSITY_MAX_UNION;
+
+    for (T *t_set : sets) {
+        if (t_set->is_locatable) continue;
+        if (!listed || t_set->conflicts_with_all) {
+            terms->push_back(Density_Term());
+            terms->back().a = t_set->interactions;
+            if (d > DENSITY_MAX_UNION) terms->back().a.resize(1);   // then just its first Interaction
+            continue;
+        }
+        for (T *other : t_set->location_conflicts) {
+            if (other->index < t_set->index) continue;  // each conflict once
+            terms->push_back(Density_Term());
+            terms->back().kind = DENSITY_SEPARATE;
+            terms->back().a = t_set->interactions;
+            terms->back().b = other->interactions;
+        }
+    }
+    if (p != prop_mode::all) return;
+    for (Interaction *i : interactions) {
+        if (i->is_detectable) continue;
+        if (!listed) {
+            terms->push_back(Density_Term());
+            terms->back().a.push_back(i);
+            continue;
+        }
+        for (auto &kv : i->deltas) {
+            if (kv.second >= delta) continue;
+            terms->push_back(Density_Term());
+            terms->back().kind = DENSITY_EXCLUDE;
+            terms->back().a.push_back(i);
+            terms->back().b = kv.first->interactions;
+        }
+    }
+}
+
+/* SUB METHOD: heuristic_density - builds a row one factor at a time, never lowering the number of issues
+ * it is expected to solve
+ *
+ * parameters:
+ * - row: integer array to fill in with the new row's values
+ *
+ * returns:
+ * - void, but after the method finishes, row will hold the new row
+*/
+void Array::heuristic_density(uint16_t *row)
+{
+    std::vector<Density_Term> terms;
+    density_terms(&terms);
+
+    // the terms listed under each factor they involve; fixing a factor changes only their chances
+    std::vector<std::vector<uint64_t>> by_factor(num_factors);
+    std::vector<uint64_t> last_listed(num_factors, UINT64_MAX);
+    for (uint64_t idx = 0; idx < terms.size(); idx++)
+        for (std::vector<Interaction*> *list : {&terms[idx].a, &terms[idx].b})
+            for (Interaction *i : *list)
+                for (Single *s : i->singles) {
+                    if (last_listed[s->factor] == idx) continue;
+                    last_listed[s->factor] = idx;
+                    by_factor[s->factor].push_back(idx);
+                }
+
+    std::vector<bool> fixed(num_factors, false);
+    double best_gain = 0;
+    for (uint16_t col = 0; col < num_factors; col++) {
+        fixed[col] = true;
+        uint16_t best_value = 0;
+        for (uint16_t value = 0; value < factors[col]->level; value++) {
+            row[col] = value;
+            double gain = 0;
+            for (uint64_t idx : by_factor[col]) gain += term_chance(&terms[idx], row, &fixed, factors);
+            if (value == 0 || gain > best_gain) {
+                best_gain = gain;
+                best_value = value;
+            }
+        }
+        row[col] = best_value;
+    }
+    if (debug == d_on) {
+        double expected = 0;
+        for (Density_Term &term : terms) expected += term_chance(&term, row, &fixed, factors);
+        printf("==%d== Density row solves %.0f of %llu listed issues\n", getpid(), expected,
+            static_cast<unsigned long long>(terms.size()));
+    }
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: chance_all - chance that every Interaction in part of a list occurs in a random completion
+ *
+ * parameters:
+ * - list: Interactions to choose from
+ * - mask: which of them to include, by bit
+ * - row: values of the factors fixed so far
+ * - fixed: which factors are fixed so far
+ * - factors: the Array's factors
+ *
+ * returns:
+ * - the chance, which is 0 when two of the Singles involved disagree
+*/
+static double chance_all(std::vector<Interaction*> *list, uint64_t mask, uint16_t *row,
+    std::vector<bool> *fixed, Factor **factors)
+{
+    Single *seen[DENSITY_MAX_UNION*8];  // Singles on free factors so far; t is small for any listed term
+    uint16_t num_seen = 0;
+    double chance = 1;
+    for (uint64_t k = 0; k < list->size(); k++) {
+        if (!((mask >> k) & 1)) continue;
+        for (Single *s : (*list)[k]->singles) {
+            if ((*fixed)[s->factor]) {
+                if (row[s->factor] != s->value) return 0;
+                continue;
+            }
+            bool repeat = false;
+            for (uint16_t j = 0; j < num_seen && !repeat; j++) {
+                if (seen[j]->factor != s->factor) continue;
+                if (seen[j]->value != s->value) return 0;
+                repeat = true;
+            }
+            if (repeat) continue;
+            if (num_seen < DENSITY_MAX_UNION*8) seen[num_seen++] = s;
+            chance /= factors[s->factor]->level;
+        }
+    }
+    return chance;
+}
+
+// chance that any Interaction in the list occurs, by inclusion-exclusion over chance_all()
+static double chance_any(std::vector<Interaction*> *list, uint16_t *row, std::vector<bool> *fixed,
+    Factor **factors)
+{
+    if (list->size() == 1) return chance_all(list, 1, row, fixed, factors);
+    double chance = 0;
+    for (uint64_t mask = 1; mask < (1ULL << list->size()); mask++)
+        chance += (__builtin_popcountll(mask) % 2 ? 1 : -1)*chance_all(list, mask, row, fixed, factors);
+    return chance;
+}
+
+// chance that a random completion of the row helps with the term's issue
+static double term_chance(Density_Term *term, uint16_t *row, std::vector<bool> *fixed, Factor **factors)
+{
+    if (term->kind == DENSITY_OCCUR) return chance_any(&term->a, row, fixed, factors);
+    std::vector<Interaction*> both = term->a;
+    both.insert(both.end(), term->b.begin(), term->b.end());
+    double either = chance_any(&both, row, fixed, factors);
+    double b_only = chance_any(&term->b, row, fixed, factors);
+    if (term->kind == DENSITY_EXCLUDE) return either - b_only;     // a without b
+    return 2*either - chance_any(&term->a, row, fixed, factors) - b_only;  // exactly one of a and b
+}
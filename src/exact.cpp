@@ -0,0 +1,364 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h,  |
+| and for the classes declared in exact.h. Specifically, it holds exact mode: for small inputs, rather than |
+| building an array greedily, solve_exact() tries 1 row, then 2, and so on, searching every array of each  |
+| size until one has every requested property; the first found therefore has the fewest rows possible.     |
+| Rows are chosen in lexicographic order (see exact.h), and since relabeling the values of a column changes |
+| no property, some row can always be relabeled to all zeros, which then comes first; so the search starts |
+| from that row. A partial array is abandoned as soon as a counting bound shows it cannot be finished:     |
+| each row holds exactly one Interaction over each set of t columns, so the rows still to come must at      |
+| least match the occurrences still needed over any one set of columns; and since rows only ever increase, |
+| an Interaction still needed must occur in some row not yet passed. Threads split the second row's        |
+| choices between them. When time runs out, the size being searched is the best bound known.              |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include "exact.h"
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// most possible rows (the product of all levels) an exact search is attempted for
+#define EXACT_MAX_CANDIDATES 65536
+
+// most rows an exact search goes up to; each Interaction's rows must fit in one 64-bit word
+#define EXACT_MAX_ROWS 64
+
+// search nodes between checks of the clock, minus 1
+#define EXACT_CLOCK_MASK 4095
+
+// method forward declarations
+static void decode_row(Factor **factors, uint16_t num_factors, uint64_t number, uint16_t *row);
+
+// ===============================v=v=v== Exact_Search methods ==v=v=v================================ //
+
+/* CONSTRUCTOR - initializes the object
+ * - starts with no rows chosen, so every Interaction is still needed in full
+*/
+Exact_Search::Exact_Search(Exact_Problem *problem) : problem(problem)
+{
+    counts.assign(problem->column_set.size(), 0);
+    words.assign(problem->column_set.size(), 0);
+    deficit.assign(problem->num_column_sets, 0);
+    for (uint32_t column_set : problem->column_set) deficit[column_set] += problem->need;
+    t_words.assign(problem->set_interactions.size(), 0);
+}
+
+void Exact_Search::add(uint64_t row)
+{
+    uint64_t bit = 1ULL << chosen.size();
+    const uint32_t *found = &problem->row_interactions[row*problem->per_row];
+    for (uint32_t k = 0; k < problem->per_row; k++) {
+        uint32_t i = found[k];
+        if (counts[i] < problem->need) deficit[problem->column_set[i]]--;
+        counts[i]++;
+        words[i] |= bit;
+    }
+    chosen.push_back(row);
+}
+
+void Exact_Search::remove(uint64_t row)
+{
+    chosen.pop_back();
+    uint64_t bit = 1ULL << chosen.size();
+    const uint32_t *found = &problem->row_interactions[row*problem->per_row];
+    for (uint32_t k = 0; k < problem->per_row; k++) {
+        uint32_t i = found[k];
+        counts[i]--;
+        if (counts[i] < problem->need) deficit[problem->column_set[i]]++;
+        words[i] &= ~bit;
+    }
+}
+
+/* SUB METHOD: bounds - checks whether the chosen rows could still be finished
+ *
+ * parameters:
+ * - remaining: rows still to be chosen
+ * - min_row: lowest row number the next row may have
+ * - limit: where to put the highest row number the next row may have
+ *
+ * returns:
+ * - false when no choice of the remaining rows can give every Interaction the occurrences it needs
+*/
+bool Exact_Search::bounds(uint16_t remaining, uint64_t min_row, uint64_t *limit)
+{
+    for (uint64_t needed : deficit) if (needed > remaining) return false;
+    *limit = problem->num_rows - 1;
+    if (remaining == 0) return true;
+    // every Interaction still needed must occur in some later row, and the next row is the lowest of them
+    for (uint64_t i = 0; i < counts.size(); i++)
+        if (counts[i] < problem->need && problem->last_row[i] < *limit) *limit = problem->last_row[i];
+    if (*limit < min_row) return false;
+    if (problem->distinct && problem->num_rows - min_row < remaining) return false;
+    return true;
+}
+
+/* SUB METHOD: search - tries every way of finishing the chosen rows, up to the given number of rows
+ *
+ * parameters:
+ * - rows: number of rows the array is to have
+ * - min_row: lowest row number the next row may have
+ *
+ * returns:
+ * - whether an array was found; if so, its rows are in the problem's solution
+*/
+bool Exact_Search::search(uint16_t rows, uint64_t min_row)
+{
+    if (problem->stop || out_of_time()) return false;
+    uint16_t remaining = rows - chosen.size();
+    uint64_t limit;
+    if (!bounds(remaining, min_row, &limit)) return false;
+    if (remaining == 0) return holds();
+    for (uint64_t row = min_row; row <= limit; row++) {
+        add(row);
+        bool found = search(rows, problem->distinct ? row + 1 : row);
+        remove(row);
+        if (found) return true;
+        if (problem->stop) return false;
+    }
+    return false;
+}
+
+bool Exact_Search::out_of_time()
+{
+    if ((++nodes & EXACT_CLOCK_MASK) != 0) return false;
+    bool cancelled = problem->cancel_token && problem->cancel_token->load(std::memory_order_relaxed);
+    if (!cancelled && std::chrono::steady_clock::now() <= problem->deadline) return false;
+    problem->timed_out = true;
+    problem->stop = true;
+    return true;
+}
+
+/* HELPER METHOD: holds - checks location and detection once the rows are complete
+ * - coverage (and δ occurrences for detection) already holds by then, as bounds() checks it
+ *
+ * returns:
+ * - whether the chosen rows have every requested property; if so, they are recorded as the solution
+*/
+bool Exact_Search::holds()
+{
+    if (problem->locate) {
+        for (uint64_t s = 0; s < t_words.size(); s++) {
+            t_words[s] = 0;
+            for (uint32_t i : problem->set_interactions[s]) t_words[s] |= words[i];
+        }
+        // no two distinct T sets may occur in exactly the same rows
+        std::vector<uint64_t> order = t_words;
+        std::sort(order.begin(), order.end());
+        if (std::adjacent_find(order.begin(), order.end()) != order.end()) return false;
+    }
+    if (problem->detect) {
+        for (uint32_t i = 0; i < words.size(); i++)
+            for (uint64_t s = 0; s < t_words.size(); s++) {
+                if (__builtin_popcountll(words[i] & ~t_words[s]) >= problem->delta) continue;
+                const std::vector<uint32_t> &members = problem->set_interactions[s];
+                if (std::find(members.begin(), members.end(), i) == members.end()) return false;
+            }
+    }
+    std::lock_guard<std::mutex> guard(problem->found_lock);
+    if (problem->stop) return false;    // another thread got there first
+    problem->solution = chosen;
+    problem->stop = true;
+    return true;
+}
+
+// ===============================^=^=^== Exact_Search methods ==^=^=^================================ //
+
+/* SUB METHOD: solve_exact - fills an empty array with the fewest rows that give it every requested property
+ * - only meant for small inputs; does nothing if the array already has rows
+ *
+ * parameters:
+ * - seconds: wall clock time to spend
+ *
+ * returns:
+ * - the number of rows in the array found, or 0 if none was found in time
+*/
+uint64_t Array::solve_exact(double seconds)
+{
+    if (num_tests != 0 || score == 0 || !(seconds > 0)) return 0;
+    Exact_Problem problem;
+    if (!exact_tables(&problem)) {
+        if (o != silent)
+            printf("NOTE: too many possible rows for an exact search, building greedily instead\n");
+        return 0;
+    }
+    std::chrono::duration<double> budget(seconds);
+    problem.deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+    problem.cancel_token = cancel_token;
+
+    uint16_t rows = exact_lower_bound(&problem);
+    for (; rows <= EXACT_MAX_ROWS; rows++) {
+        if (o == normal) printf("Searching every array with %u rows....\n", rows);
+        if (exact_rows(&problem, rows)) break;
+        if (problem.timed_out) {
+            if (o != silent)
+                printf("Out of time; no array has fewer than %u rows. Building greedily instead.\n", rows);
+            return 0;
+        }
+    }
+    if (rows > EXACT_MAX_ROWS) {
+        if (o != silent) printf("NOTE: no array with at most %d rows exists, building greedily instead\n",
+            EXACT_MAX_ROWS);
+        return 0;
+    }
+
+    std::vector<uint16_t*> block;
+    for (uint64_t number : problem.solution) {
+        uint16_t *row = new uint16_t[num_factors];
+        decode_row(factors, num_factors, number, row);
+        block.push_back(row);
+    }
+    load_rows(&block);
+    for (uint16_t *row : block) delete[] row;
+    if (o != silent) printf("Found an array with %u rows; no array with fewer exists.\n", rows);
+    return num_tests;
+}
+
+/* HELPER METHOD: exact_tables - fills in the tables an exact search reads
+ *
+ * parameters:
+ * - problem: problem to fill in
+ *
+ * returns:
+ * - false if there are too many possible rows to search
+*/
+bool Array::exact_tables(Exact_Problem *problem)
+{
+    problem->num_rows = 1;
+    for (uint16_t col = 0; col < num_factors; col++) {
+        problem->num_rows *= factors[col]->level;
+        if (problem->num_rows > EXACT_MAX_CANDIDATES) return false;
+    }
+    problem->locate = p != c_only;
+    problem->detect = p == prop_mode::all;
+    problem->delta = delta;
+    problem->need = problem->detect ? delta : 1;
+    problem->distinct = !problem->detect;
+
+    std::map<std::vector<uint16_t>, uint32_t> column_sets;
+    for (Interaction *i : interactions) {
+        std::vector<uint16_t> columns;
+        uint64_t last = 0;  // highest row number: the Interaction's values, and the top level elsewhere
+        uint64_t s = 0;
+        for (uint16_t col = 0; col < num_factors; col++) {
+            uint16_t value = factors[col]->level - 1;
+            if (s < i->singles.size() && i->singles[s]->factor == col) {
+                value = i->singles[s++]->value;
+                columns.push_back(col);
+            }
+            last = last*factors[col]->level + value;
+        }
+        auto inserted = column_sets.insert({columns, column_sets.size()});
+        problem->column_set.push_back(inserted.first->second);
+        problem->last_row.push_back(last);
+    }
+    problem->num_column_sets = column_sets.size();
+
+    uint16_t *row = new uint16_t[num_factors];
+    for (uint64_t number = 0; number < problem->num_rows; number++) {
+        decode_row(factors, num_factors, number, row);
+        std::set<Interaction*> found;
+        find_row_interactions(row, &found);
+        if (number == 0) problem->per_row = found.size();
+        for (Interaction *i : found) problem->row_interactions.push_back(i->index);
+    }
+    delete[] row;
+
+    if (problem->locate)
+        for (T *t_set : sets) {
+            std::vector<uint32_t> members;
+            for (Interaction *i : t_set->interactions) members.push_back(i->index);
+            problem->set_interactions.push_back(members);
+        }
+    return true;
+}
+
+/* HELPER METHOD: exact_lower_bound - the fewest rows an array could possibly have
+ * - each set of t columns needs every combination of its values, each as often as an Interaction must
+ *   occur; and for location, every T set needs its own nonempty set of rows
+ *
+ * parameters:
+ * - problem: problem with its tables filled in
+ *
+ * returns:
+ * - number of rows to begin the search at
+*/
+uint16_t Array::exact_lower_bound(Exact_Problem *problem)
+{
+    uint64_t bound = 1;
+    std::vector<uint64_t> per_set(problem->num_column_sets, 0);
+    for (uint32_t column_set : problem->column_set) per_set[column_set] += problem->need;
+    for (uint64_t needed : per_set) bound = std::max(bound, needed);
+    if (problem->locate)
+        while (bound < EXACT_MAX_ROWS && (1ULL << bound) - 1 < problem->set_interactions.size()) bound++;
+    return static_cast<uint16_t>(std::min<uint64_t>(bound, EXACT_MAX_ROWS + 1));
+}
+
+/* HELPER METHOD: exact_rows - searches every array with the given number of rows
+ * - the first row is all zeros (see the top of this file); threads take turns choosing the second row
+ *
+ * parameters:
+ * - problem: problem with its tables filled in
+ * - rows: number of rows
+ *
+ * returns:
+ * - whether an array was found; if so, its rows are in the problem's solution
+*/
+bool Array::exact_rows(Exact_Problem *problem, uint16_t rows)
+{
+    problem->stop = false;
+    Exact_Search first(problem);
+    first.add(0);
+    uint64_t min_row = problem->distinct ? 1 : 0, limit;
+    if (!first.bounds(rows - 1, min_row, &limit)) return false;
+    if (rows == 1) return first.search(rows, min_row);
+
+    uint64_t branches = limit - min_row + 1;
+    uint32_t threads = std::max<uint32_t>(1, std::min<uint64_t>(max_threads, branches));
+    std::atomic<uint64_t> next(0);
+    auto body = [&]() {
+        Exact_Search search(problem);
+        search.add(0);
+        for (uint64_t branch = next++; branch < branches && !problem->stop; branch = next++) {
+            uint64_t row = min_row + branch;
+            search.add(row);
+            search.search(rows, problem->distinct ? row + 1 : row);
+            search.remove(row);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (uint32_t thread = 1; thread < threads; thread++) pool.emplace_back(body);
+    body();
+    for (std::thread &cur_thread : pool) cur_thread.join();
+    return !problem->solution.empty();
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: decode_row - turns a row number back into the row's values
+ *
+ * parameters:
+ * - factors: the Array's factors
+ * - num_factors: number of factors
+ * - number: row number, reading the values as digits with the first column most significant
+ * - row: where to write the values
+ *
+ * returns:
+ * - void, but after the method finishes, row will hold the values
+*/
+static void decode_row(Factor **factors, uint16_t num_factors, uint64_t number, uint16_t *row)
+{
+    for (uint16_t col = num_factors; col > 0; col--) {
+        row[col - 1] = number % factors[col - 1]->level;
+        number /= factors[col - 1]->level;
+    }
+}
@@ -0,0 +1,93 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains the classes behind Array::solve_exact(), which finds an array with the fewest rows |
+| possible by trying every one. Each possible row is numbered by reading its values as digits, the first    |
+| column most significant, so numbers follow lexicographic order; an array is then a nondecreasing list of  |
+| row numbers, which means each set of rows is tried once and not once per ordering. Exact_Problem holds    |
+| the tables every search thread reads: which Interactions each possible row has, which columns each        |
+| Interaction is over, and which Interactions make up each T set. Exact_Search is one thread's working     |
+| state: how often each Interaction occurs so far, and its rows as a bitmap (a single word, since exact     |
+| search is only practical well under 64 rows). Counting bounds rule out most partial arrays long before    |
+| all their rows are chosen; location and detection are only checked once the rows are complete.            |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef EXACT
+#define EXACT
+
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+class Exact_Problem
+{
+    public:
+        // possible rows, that is, the product of all levels
+        uint64_t num_rows = 0;
+
+        // Interactions in each possible row, the same for every row
+        uint32_t per_row = 0;
+
+        // indices of each possible row's Interactions, per_row entries per row laid out contiguously
+        std::vector<uint32_t> row_interactions;
+
+        // for each Interaction, by index: which set of t columns it is over, and the highest-numbered
+        // possible row it occurs in
+        std::vector<uint32_t> column_set;
+        std::vector<uint64_t> last_row;
+        uint32_t num_column_sets = 0;
+
+        // indices of the Interactions making up each T set, by index
+        std::vector<std::vector<uint32_t>> set_interactions;
+
+        // times each Interaction must occur: δ for detecting arrays, since an Interaction occurring fewer
+        // times cannot be separated from anything by δ rows, and 1 otherwise
+        uint16_t need = 1;
+
+        // which properties to check once the rows are complete, and the separation detection needs
+        bool locate = false, detect = false;
+        uint16_t delta = 1;
+
+        // whether a row may be repeated; only detection can ever be helped by a repeat
+        bool distinct = true;
+
+        // when to give up, and the cancel token of the Array (if any)
+        std::chrono::steady_clock::time_point deadline;
+        std::atomic<bool> *cancel_token = nullptr;
+
+        // set once any thread finds an array or runs out of time, so the others stop too
+        std::atomic<bool> stop{false}, timed_out{false};
+
+        // row numbers of the array found, guarded by found_lock
+        std::vector<uint64_t> solution;
+        std::mutex found_lock;
+};
+
+class Exact_Search
+{
+    public:
+        Exact_Search(Exact_Problem *problem);
+        void add(uint64_t row);         // appends a possible row to the rows chosen so far
+        void remove(uint64_t row);      // takes the last chosen row back off
+        bool bounds(uint16_t remaining, uint64_t min_row, uint64_t *limit);
+        bool search(uint16_t rows, uint64_t min_row);
+
+    private:
+        Exact_Problem *problem;
+        std::vector<uint64_t> chosen;       // row numbers chosen so far, nondecreasing
+        std::vector<uint16_t> counts;       // times each Interaction occurs in them
+        std::vector<uint64_t> words;        // rows each Interaction occurs in, as a bitmap
+        std::vector<uint64_t> deficit;      // per set of columns, occurrences still needed
+        std::vector<uint64_t> t_words;      // scratch for holds()
+        uint64_t nodes = 0;
+
+        bool out_of_time();
+        bool holds();                       // whether the chosen rows have every property
+};
+
+#endif // EXACT
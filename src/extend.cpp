@@ -0,0 +1,225 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds extension of an existing array (--extend), either with new factors, with new      |
+| values for existing factors, or both. The Array is built for the full, new list of factors and levels as |
+| usual; the existing rows are then adapted before they are added, in two steps:                          |
+| - new columns are filled in by the horizontal growth step of IPOG: the new columns are assigned one at a |
+|   time, and in each existing row, the value chosen is the one that covers the most t-way interactions   |
+|   (between the new column and columns already assigned) that no earlier row has covered yet             |
+| - for factors that gained values (an old level is read off as one more than the largest value in the    |
+|   existing rows), an occurrence of an old value is relabeled to a new one wherever every interaction it  |
+|   was part of is also covered by another row, and the new value covers interactions nothing else does yet |
+| Whatever coverage, location, or detection is still missing after that is left to the usual row-by-row  |
+| generation, which then only has to add the rows the change actually needs.                              |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <algorithm>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+/* SUB METHOD: extend_rows - adapts existing rows to new factors and levels, then adds them to the array
+ * - the rows are copied out of the matrix, adapted, then added as in load_rows(); the matrix is left as it is
+ *
+ * parameters:
+ * - matrix: the existing rows, each num_factors long; only the first old_cols values of each are meaningful
+ * - old_cols: number of columns the existing rows had
+ *
+ * returns:
+ * - the number of t-way interactions the adapted rows cover that they did not before
+*/
+uint64_t Array::extend_rows(const Row_Matrix *matrix, uint16_t old_cols)
+{
+    std::vector<uint16_t*> block;
+    for (uint64_t r = 0; r < matrix->size(); r++) {
+        block.push_back(new uint16_t[num_factors]);
+        matrix->copy_row(r, block.back());
+    }
+    uint64_t newly_covered = fill_columns(&block, old_cols) + relabel_levels(&block, old_cols);
+    load_rows(&block);
+    for (uint16_t *row : block) delete[] row;
+    return newly_covered;
+}
+
+/* HELPER METHOD: fill_columns - fills in the new columns of existing rows
+ *
+ * parameters:
+ * - block: the existing rows, each num_factors long; only the first old_cols values of each are meaningful
+ * - old_cols: number of columns the existing rows had
+ *
+ * returns:
+ * - the number of new t-way interactions the filled-in columns cover
+*/
+uint64_t Array::fill_columns(std::vector<uint16_t*> *block, uint16_t old_cols)
+{
+    std::vector<bool> covered(interactions.size(), false);  // by Interaction::index, among the new ones
+    uint64_t newly_covered = 0;
+    for (uint16_t col = old_cols; col < num_factors; col++) {
+        uint16_t level = factors[col]->level;
+        std::vector<uint64_t> uses(level, 0);  // how often each value has been chosen so far in this column
+        for (uint64_t r = 0; r < block->size(); r++) {
+            uint16_t *row = block->at(r);
+            uint16_t best_value = 0;
+            int64_t best_gain = -1;
+            std::vector<Interaction*> best_new;
+            for (uint16_t offset = 0; offset < level; offset++) {
+                uint16_t value = (r + offset) % level;  // rotates the starting value, for balance among ties
+                std::vector<Interaction*> gained;
+                row[col] = value;
+                column_interactions(row, col, &covered, &gained);
+                int64_t gain = static_cast<int64_t>(gained.size());
+                if (gain > best_gain || (gain == best_gain && uses[value] < uses[best_value])) {
+                    best_gain = gain;
+                    best_value = value;
+                    best_new = gained;
+                }
+            }
+            row[col] = best_value;
+            uses[best_value]++;
+            for (Interaction *i : best_new) covered[i->index] = true;
+            newly_covered += best_new.size();
+        }
+        if (debug == d_on) printf("==%d== Extended column %hu; %llu new interactions covered so far\n", getpid(),
+            col, static_cast<unsigned long long>(newly_covered));
+    }
+    if (o != silent && old_cols < num_factors)
+        printf("Filled in %hu new columns for %llu existing rows, covering %llu new interactions.\n",
+            static_cast<uint16_t>(num_factors - old_cols), static_cast<unsigned long long>(block->size()),
+            static_cast<unsigned long long>(newly_covered));
+    return newly_covered;
+}
+
+/* HELPER METHOD: relabel_levels - moves redundant occurrences of old values over to factors' new values
+ * - a factor's old level is taken to be one more than the largest value it has in the existing rows
+ *
+ * parameters:
+ * - block: the existing rows, with any new columns already filled in
+ * - old_cols: number of columns the existing rows had; only these can have gained values
+ *
+ * returns:
+ * - the number of t-way interactions the relabeled values cover that nothing else did
+*/
+uint64_t Array::relabel_levels(std::vector<uint16_t*> *block, uint16_t old_cols)
+{
+    std::vector<uint16_t> old_level(old_cols, 0);
+    for (uint16_t *row : *block)
+        for (uint16_t col = 0; col < old_cols; col++)
+            old_level[col] = std::max<uint16_t>(old_level[col], row[col] + 1);
+
+    // how many of the rows each Interaction occurs in
+    std::vector<uint64_t> count(interactions.size(), 0);
+    for (uint64_t r = 0; r < block->size(); r++) {
+        std::set<Interaction*> found;
+        find_row_interactions(block->at(r), &found);
+        for (Interaction *i : found) count[i->index]++;
+    }
+
+    uint64_t newly_covered = 0, relabeled = 0;
+    for (uint16_t col = 0; col < old_cols; col++) {
+        if (old_level[col] >= factors[col]->level) continue;    // this factor gained no values
+        for (uint16_t *row : *block) {
+            // the old value can only go if every interaction it is part of here occurs in another row too
+            std::vector<Interaction*> losing;
+            involving_column(row, col, &losing);
+            bool redundant = true;
+            for (Interaction *i : losing) redundant = redundant && count[i->index] > 1;
+            if (!redundant) continue;
+
+            // pick the new value that covers the most interactions nothing covers yet
+            uint16_t old_value = row[col], best_value = old_value;
+            uint64_t best_gain = 0;
+            for (uint16_t value = old_level[col]; value < factors[col]->level; value++) {
+                std::vector<Interaction*> gaining;
+                row[col] = value;
+                involving_column(row, col, &gaining);
+                uint64_t gain = 0;
+                for (Interaction *i : gaining) gain += count[i->index] == 0;
+                if (gain > best_gain) {
+                    best_gain = gain;
+                    best_value = value;
+                }
+            }
+            row[col] = old_value;
+            if (best_value == old_value) continue;
+            for (Interaction *i : losing) count[i->index]--;
+            row[col] = best_value;
+            std::vector<Interaction*> gaining;
+            involving_column(row, col, &gaining);
+            for (Interaction *i : gaining) count[i->index]++;
+            newly_covered += best_gain;
+            relabeled++;
+        }
+    }
+    if (o != silent && relabeled > 0)
+        printf("Relabeled %llu existing values to new levels, covering %llu new interactions.\n",
+            static_cast<unsigned long long>(relabeled), static_cast<unsigned long long>(newly_covered));
+    return newly_covered;
+}
+
+/* HELPER METHOD: column_interactions - finds the not yet covered interactions a value in a new column forms
+ * - only interactions whose last (highest) column is col are formed, all other columns being lower than it
+ *
+ * parameters:
+ * - row: the row being extended, with its values up to and including col assigned
+ * - col: the column just assigned
+ * - covered: which Interactions (by index) are already covered by earlier rows' new columns
+ * - gained: initially empty vector to hold the uncovered Interactions the row would cover
+ *
+ * returns:
+ * - void, but after the method finishes, gained will hold those Interactions
+*/
+void Array::column_interactions(uint16_t *row, uint16_t col, std::vector<bool> *covered,
+    std::vector<Interaction*> *gained)
+{
+    if (t == 1) {
+        Interaction *i = interaction_map.at(factors[col]->singles[row[col]]->to_string());
+        if (!covered->at(i->index)) gained->push_back(i);
+        return;
+    }
+    std::vector<uint16_t> cols(t - 1);  // the other t-1 columns, as an increasing combination below col
+    for (uint16_t j = 0; j < t - 1; j++) cols[j] = j;
+    if (col < t - 1) return;
+    while (true) {
+        std::string key;
+        for (uint16_t c : cols) key += factors[c]->singles[row[c]]->to_string();
+        key += factors[col]->singles[row[col]]->to_string();
+        Interaction *i = interaction_map.at(key);
+        if (!covered->at(i->index)) gained->push_back(i);
+
+        // next combination
+        int32_t j = t - 2;
+        while (j >= 0 && cols[j] == col - (t - 1) + j) j--;
+        if (j < 0) break;
+        cols[j]++;
+        for (uint16_t k = j + 1; k < t - 1; k++) cols[k] = cols[k-1] + 1;
+    }
+}
+
+/* HELPER METHOD: involving_column - finds every Interaction in a row that includes a given column
+ *
+ * parameters:
+ * - row: integer array representing a fully assigned row
+ * - col: the column of interest
+ * - found: initially empty vector to hold the Interactions
+ *
+ * returns:
+ * - void, but after the method finishes, found will hold the row's Interactions that include col
+*/
+void Array::involving_column(uint16_t *row, uint16_t col, std::vector<Interaction*> *found)
+{
+    std::set<Interaction*> all_found;
+    find_row_interactions(row, &all_found);
+    for (Interaction *i : all_found)
+        for (Single *s : i->singles)
+            if (s->factor == col) {
+                found->push_back(i);
+                break;
+            }
+}
@@ -18,6 +18,14 @@ Last updated 11/14/2022
 Single::Single(uint64_t f, uint64_t v) : factor(f), value(v), str_rep(this->to_string_internal())
 {
     // rows will be built later
+    memory_note(mem_singles, sizeof(Single) + heap_bytes(str_rep));
+}
+
+/* DECONSTRUCTOR - uncounts the Single's memory (see memory.h)
+*/
+Single::~Single()
+{
+    memory_note(mem_singles, -static_cast<int64_t>(sizeof(Single) + heap_bytes(str_rep)));
 }
 
 /* UTILITY METHOD: to_string - gets a string representation of the Single
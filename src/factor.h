@@ -23,6 +23,7 @@ Last updated 11/14/2022
 #define FACTOR
 
 #include "parser.h"
+#include "memory.h"
 #include <set>
 
 // basically just a tuple, but with a set of rows in which it occurs
@@ -45,13 +46,14 @@ class Single
         const uint16_t value;
 
         // tracks the set of rows in which this (factor, value) occurs
-        std::set<uint64_t> rows;
+        counted_set<uint64_t, mem_singles> rows;
 
         // memoized to_string_internal
         const std::string str_rep;
 
         std::string to_string() const;  // returns a string representing the (factor, value)
         Single(uint64_t f, uint64_t v); // constructor that takes the (factor, value)
+        ~Single();                      // deconstructor
 
     private:
         std::string to_string_internal() const;
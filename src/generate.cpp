@@ -30,10 +30,13 @@ Last updated 12/22/2022
 
 #include "parser.h"
 #include "array.h"
+#include "progress.h"
+#include "plan.h"
 #include <sys/types.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <memory>
 #include <Rcpp.h>
 #include <RcppCommon.h>
 
@@ -55,6 +58,7 @@ static prop_mode pm;    // property mode
 static int32_t print_usage();
 static int32_t print_results(Parser *p, Array *array, bool success);
 static void debug_print(uint8_t d, uint8_t t, uint8_t delta);
+static bool print_progress(const Progress_Report &report);
 
 // =========================^=^=^== static methods - forward declarations ==^=^=^========================= //
 
@@ -82,28 +86,49 @@ int32_t main(int32_t argc, char *argv[])
 	int32_t status = p.process_input();             // read in and process the array
     if (status == -1) return 1;         // exit immediately if there is a basic syntactic or semantic error
     if (dm == d_on) debug_print(p.d, p.t, p.delta); // print status when verbose mode enabled
+    if (p.plan) {       // size the job instead of running it
+        Plan plan = plan_array(&p);
+        print_plan(plan);
+        return plan.feasible ? 0 : 1;
+    }
     
-    Array array(&p);    // create Array object that immediately builds appropriate data structures
+    std::unique_ptr<Array> built;
+    try {
+        built.reset(new Array(&p));     // create Array object that immediately builds its data structures
+    } catch (const std::bad_alloc &e) {
+        return 1;       // the constructor has already said why
+    }
+    Array &array = *built;
     if (array.score == 0) {
         printf("Nothing to do.\n\n");
         return 0;
     }
-    for (uint16_t *row : p.array) array.add_row(row);   // add any partial array rows, if given
+    if (p.extend) array.extend_rows(&p.array, p.extend_cols);   // existing rows, adapted to new factors/levels
+    else for (uint64_t r = 0; r < p.array.size(); r++) array.add_row(p.array.row(r).data());  // partial rows
+    if (p.seed) array.add_seed();   // start from an algebraic construction when one fits the levels
+    if (p.ipog) array.add_ipog();   // or build the coverage one column at a time
 
     array.print_stats(true);        // report initial state of array
-    if (array.score == 0) return 0; // when the partial array already solved all problems
-    uint64_t prev_score;            // for comparing to current score to see if nothing is changing
-    uint8_t no_change_counter = 0;  // need this to stop an infinite loop if the array cannot be completed
-    while (array.score > 0) {       // add rows until the array is complete
-        prev_score = array.score;   // needed for catching impossible scenarios
-        array.add_row();            // add another row
-        if (array.out_of_memory) break;
-        if (array.score == prev_score) no_change_counter++;
-        else no_change_counter = 0;
-        if (no_change_counter > 10) break;
-        array.print_stats();        // report current state of array
+    if (array.score == 0) {         // partial array, seed, or IPOG solved it all
+        if (p.shrink > 0) array.shrink(p.shrink);
+        return print_results(&p, &array, true);
+    }
+    if (p.exact > 0 && array.solve_exact(p.exact) > 0) {   // small inputs: the fewest rows possible
+        if (vm == v_on) array.verify();
+        return print_results(&p, &array, true);
     }
-    return print_results(&p, &array, (no_change_counter == 0 || array.out_of_memory));
+    Progress progress(p.progress, p.progress >= 0 && om != silent ? print_progress : progress_callback(),
+        p.trace_filename);
+    std::function<void()> after_row = nullptr;  // only track progress when it was asked for
+    if (p.progress >= 0 || !p.trace_filename.empty()) after_row = [&]() { progress.update(&array); };
+    bool success = array.complete(p.batch, after_row);  // add rows until the array is complete
+    if (after_row) progress.update(&array, true);
+    if (success && p.shrink > 0) array.shrink(p.shrink);    // then try to do with fewer rows
+    if (vm == v_on) {
+        array.print_strategies();   // how each strategy did
+        array.verify();             // independent check of the incremental bookkeeping
+    }
+    return print_results(&p, &array, success);
 }
 
 /* HELPER METHOD: print_usage - prints info about the usage of the program
@@ -120,6 +145,22 @@ static int32_t print_usage()
     printf("\t-s          : silent mode (prints no output, cancels other output flags)\n");
     printf("\t-v          : verbose mode (prints more output than normal)\n");
     printf("\t--partial   : use partially complete array; a filepath must follow this flag\n");
+    printf("\t--extend    : like --partial, but the array's rows may lack the input's last factors, and its\n");
+    printf("\t              factors may have fewer levels; rows are adapted first; a filepath must follow this flag\n");
+    printf("\t--seed      : start from an orthogonal array construction when the levels allow one\n");
+    printf("\t--ipog      : start from a covering array built one column at a time (fast for many factors)\n");
+    printf("\t--plan      : only print the sizes, memory, and minimum rows the job would need, then stop\n");
+    printf("\t--density   : build each row deterministically, one factor at a time (density algorithm)\n");
+    printf("\t--strategy  : build rows with the named strategies, tried in order; comma-separated names follow\n");
+    printf("\t--effort    : schedule heuristics by measured throughput; an int 0 (fast) to 10 (few rows) follows\n");
+    printf("\t--batch     : choose rows jointly in batches; the batch size must follow this flag\n");
+    printf("\t--progress  : print rates and an estimate of rows left; seconds between lines must follow\n");
+    printf("\t--trace     : write the score after every row as CSV; a filepath must follow this flag\n");
+    printf("\t--memory    : memory budget in MB, past which detection state is kept on disk; MB must follow\n");
+    printf("\t--workers   : number of processes to score candidate rows across; number must follow\n");
+    printf("\t--shrink    : afterwards, search for ways to remove rows; seconds to spend must follow\n");
+    printf("\t--exact     : for small inputs, search for an array with the fewest rows; seconds must follow\n");
+    printf("\t--stagnation: rows to spend getting unstuck before giving up (200 by default); rows must follow\n");
     printf("\t--help      : print help message (what you are seeing here)\n");
     printf("arguments (assume order matters):\n");
     printf("\tt           : strength of interactions, needed for all types of arrays\n");
@@ -131,6 +172,26 @@ static int32_t print_usage()
     return 0;
 }
 
+/* HELPER METHOD: print_progress - progress callback for the --progress flag
+ *
+ * parameters:
+ * - report: current progress, rates, and estimates
+ *
+ * returns:
+ * - true, since the command line version never stops early on its own
+*/
+static bool print_progress(const Progress_Report &report)
+{
+    printf("\t- Progress: %llu rows, score %llu, %.2f rows/s, %.1f score/s, %.1f MB (peak %.1f MB), ",
+        static_cast<unsigned long long>(report.rows), static_cast<unsigned long long>(report.score),
+        report.rows_per_second, report.reduction_per_second, report.session_memory_bytes/1048576.0,
+        report.session_peak_memory_bytes/1048576.0);
+    if (report.eta_rows < 0) printf("no estimate yet.\n");
+    else if (report.eta_seconds < 0) printf("about %.0f rows left.\n", report.eta_rows);
+    else printf("about %.0f rows (%.0fs) left.\n", report.eta_rows, report.eta_seconds);
+    return true;
+}
+
 /* SUB METHOD: print_results - prints the completion status after the array is finished being generated
  * 
  * parameters:
@@ -3,6 +3,11 @@
 #include "array.h"
 #include "factor.h"
 #include "parser.h"
+#include "job.h"
+#include "progress.h"
+#include "plan.h"
+#include "strategy.h"
+#include <chrono>
 
 using namespace std;
 using namespace Rcpp;
@@ -11,6 +16,7 @@ using namespace Rcpp;
 //make the exposed class visible 
 RCPP_EXPOSED_CLASS(Parser);
 RCPP_EXPOSED_CLASS(Array);
+RCPP_EXPOSED_CLASS(Job);
 
 
 Parser* parse(int32_t argc, const std::vector<std::string>& argv){
@@ -19,10 +25,247 @@ Parser* parse(int32_t argc, const std::vector<std::string>& argv){
 }
 
 Array* array_array(Parser* p){
+  p->workers = 1;  //forking the R session is unsafe, so heuristic_all() scores in this process (see workers.cpp)
   Array*  ar= new Array(p);
   return ar;
 }
 
+//fill an R integer matrix (one row per test, one column per factor) straight from the row storage
+IntegerMatrix array_to_matrix(Array* ar){
+  uint64_t num_rows = ar->getNum_Tests();
+  uint16_t num_cols = ar->getNum_Factors();
+  IntegerMatrix m(num_rows, num_cols);
+  int *out = INTEGER(m);  //R matrices are column-major
+  const Row_Matrix *rows = ar->getRows();
+  for (uint16_t c = 0; c < num_cols; c++) rows->read_column(c, out + c*num_rows);  //strided
+  return m;
+}
+
+//load an R integer matrix as seed rows through the bulk path; plain matrices are read in place, and
+//ALTREP-backed ones are read one column at a time so they never have to be materialized
+void array_load_matrix(Array* ar, SEXP x){
+  if (TYPEOF(x) != INTSXP || !Rf_isMatrix(x)) stop("expected an integer matrix");
+  R_xlen_t num_rows = Rf_nrows(x);
+  int num_cols = Rf_ncols(x);
+  if (num_cols != ar->getNum_Factors())
+    stop("matrix has %d columns but the array has %d factors", num_cols, (int)ar->getNum_Factors());
+
+  std::vector<uint16_t> cells(num_rows*num_cols);
+  std::vector<uint16_t*> block(num_rows);
+  for (R_xlen_t r = 0; r < num_rows; r++) block[r] = &cells[r*num_cols];
+  const int *data = ALTREP(x) ? nullptr : INTEGER_RO(x);
+  std::vector<int> chunk;
+  for (int c = 0; c < num_cols; c++){
+    const int *col = data ? data + c*num_rows : nullptr;
+    if (!col){
+      chunk.resize(num_rows);
+      INTEGER_GET_REGION(x, c*num_rows, num_rows, chunk.data());
+      col = chunk.data();
+    }
+    for (R_xlen_t r = 0; r < num_rows; r++){
+      if (col[r] == NA_INTEGER || col[r] < 0 || col[r] >= ar->getLevel(c))
+        stop("value at row %d, column %d is outside the factor's levels", (int)r + 1, c + 1);
+      block[r][c] = col[r];
+    }
+  }
+  ar->load_rows(&block);
+}
+
+//add the parser's rows under --extend, adapted to the input's new factors and levels first, as main() does
+double array_extend_rows(Array* ar, Parser* p){
+  return (double)ar->extend_rows(&p->array, p->extend_cols);
+}
+
+//add rows until finished or stuck, as main() does; the native loop replaces the one buildLA() used to run in R
+bool array_complete(Array* ar, int batch){
+  return ar->complete(batch > 1 ? batch : 1);
+}
+
+//a progress report as a named list; estimates that are not available yet are NA
+List progress_list(const Progress_Report &report){
+  return List::create(Named("seconds") = report.seconds,
+                      Named("rows") = (double)report.rows,
+                      Named("score") = (double)report.score,
+                      Named("coverage") = (double)report.c_score,
+                      Named("location") = (double)report.l_score,
+                      Named("detection") = (double)report.d_score,
+                      Named("rows_per_second") = report.rows_per_second,
+                      Named("reduction_per_second") = report.reduction_per_second,
+                      Named("heuristic") = report.heuristic,
+                      Named("session_memory_bytes") = (double)report.session_memory_bytes,
+                      Named("session_peak_memory_bytes") = (double)report.session_peak_memory_bytes,
+                      Named("eta_rows") = report.eta_rows < 0 ? NA_REAL : report.eta_rows,
+                      Named("eta_seconds") = report.eta_seconds < 0 ? NA_REAL : report.eta_seconds,
+                      Named("final") = report.final);
+}
+
+//fill in a Parser the way process_input() would, from levels and the generateLA()-style t, d, and delta
+void set_up_parser(Parser* p, IntegerVector levels, int t, int d, int delta){
+  if (t < 1 || d < 0 || delta < 0) stop("t must be positive, and d and delta cannot be negative");
+  std::vector<uint16_t> given;
+  for (int level : levels){
+    if (level == NA_INTEGER || level < 1 || level > UINT16_MAX) stop("every level must be from 1 to 65535");
+    given.push_back(level);
+  }
+  p->t = t;
+  p->d = d > 0 ? d : 1;
+  p->delta = delta > 0 ? delta : 1;
+  p->p = d == 0 ? c_only : (delta == 0 ? c_and_l : all);
+  if (p->process_levels(given) == -1) stop("impossible to generate an array with these parameters");
+}
+
+//switch an Array that already has rows to new properties (d and delta as in generateLA()) without rebuilding
+//it or replaying its rows; d and delta are checked against the Array's levels the same way generateLA() does
+bool array_upgrade(Array* ar, int d, int delta){
+  IntegerVector levels(ar->getNum_Factors());
+  for (uint16_t col = 0; col < ar->getNum_Factors(); col++) levels[col] = ar->getLevel(col);
+  Parser p;
+  set_up_parser(&p, levels, ar->t, d, delta);
+  return ar->upgrade(p.p, p.d, p.delta);
+}
+
+//rows added, score reduction, and CPU seconds for every registered strategy, as a data frame
+DataFrame array_strategy_stats(Array* ar){
+  CharacterVector names;
+  NumericVector rows, reduction, cpu_seconds;
+  for (Strategy *s : *ar->getStrategies()){
+    names.push_back(s->name);
+    rows.push_back((double)s->rows);
+    reduction.push_back((double)s->reduction);
+    cpu_seconds.push_back(s->cpu_seconds);
+  }
+  return DataFrame::create(Named("strategy") = names, Named("rows") = rows, Named("reduction") = reduction,
+                           Named("cpu_seconds") = cpu_seconds, Named("stringsAsFactors") = false);
+}
+
+//live and peak bytes of each structure family, as a data frame; the counts are for the whole R session, so
+//with several Arrays alive (say, two startLA() jobs) they add up, and no Array's share can be told apart
+DataFrame session_memory_stats(Array*){
+  CharacterVector names;
+  NumericVector live, peak;
+  for (uint8_t f = 0; f < mem_families; f++){
+    names.push_back(memory_family_name(static_cast<mem_family>(f)));
+    live.push_back((double)memory_live(static_cast<mem_family>(f)));
+    peak.push_back((double)memory_peak(static_cast<mem_family>(f)));
+  }
+  names.push_back("Total");
+  live.push_back((double)memory_live_total());
+  peak.push_back((double)memory_peak_total());
+  return DataFrame::create(Named("structure") = names, Named("live_bytes") = live, Named("peak_bytes") = peak,
+                           Named("stringsAsFactors") = false);
+}
+
+//the whole construction in one native call: levels, t, d, and delta define the array (d = 0 asks for a
+//covering array and delta = 0 for a locating one), rows is an optional integer matrix of rows to start
+//from, and the rest mirror --seed, --effort, --batch, -s, --progress, and --trace; progress is an R function
+//given a list (see progress_list) at most every interval seconds, and returning FALSE from it stops the run
+// [[Rcpp::export(generateLA)]]
+List generate_array(IntegerVector levels, int t = 2, int d = 0, int delta = 0, SEXP rows = R_NilValue,
+                    bool seed = false, int effort = -1, int batch = 1, bool quiet = true,
+                    SEXP progress = R_NilValue, double interval = 1, std::string trace = ""){
+  Parser p;
+  set_up_parser(&p, levels, t, d, delta);
+  p.o = quiet ? silent : normal;
+  p.seed = seed;
+  p.effort = effort < 0 ? -1 : (effort > 10 ? 10 : effort);
+  p.batch = batch > 1 ? (batch > UINT16_MAX ? UINT16_MAX : batch) : 1;
+
+  auto start = std::chrono::steady_clock::now();
+  Array array(&p);
+  if (!Rf_isNull(rows)) array_load_matrix(&array, TYPEOF(rows) == INTSXP ? rows : (SEXP)IntegerMatrix(rows));
+  if (p.seed) array.add_seed();
+  std::atomic<bool> stop_requested(false);
+  array.set_cancel_token(&stop_requested);
+  progress_callback callback;
+  if (!Rf_isNull(progress)){
+    Function f(progress);
+    callback = [&f](const Progress_Report &report){
+      SEXP answer = f(progress_list(report));
+      return !(Rf_isLogical(answer) && Rf_length(answer) == 1 && LOGICAL(answer)[0] == FALSE);
+    };
+  }
+  Progress tracker(interval, callback, trace);
+  std::function<void()> after_row = nullptr;
+  if (callback || !trace.empty())
+    after_row = [&](){ if (!tracker.update(&array)) stop_requested.store(true); };
+  bool success = array.score == 0 || array.complete(p.batch, after_row);
+  if (after_row) tracker.update(&array, true);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t c_score, l_score, d_score;
+  array.getScore_Breakdown(&c_score, &l_score, &d_score);
+  return List::create(Named("array") = array_to_matrix(&array),
+                      Named("success") = success && !array.out_of_memory,
+                      Named("rows") = (double)array.getNum_Tests(),
+                      Named("score") = (double)array.score,
+                      Named("coverage") = (double)c_score,
+                      Named("location") = (double)l_score,
+                      Named("detection") = (double)d_score,
+                      Named("heuristic") = array.getHeuristic(),
+                      Named("seconds") = seconds);
+}
+
+//a plan as a named list
+List plan_list(const Plan &plan){
+  return List::create(Named("singles") = (double)plan.singles,
+                      Named("interactions") = (double)plan.interactions,
+                      Named("sets") = (double)plan.sets,
+                      Named("problems") = (double)plan.total_problems,
+                      Named("bytes") = NumericVector::create(
+                        Named("singles") = (double)plan.single_bytes,
+                        Named("interactions") = (double)plan.interaction_bytes,
+                        Named("sets") = (double)plan.set_bytes,
+                        Named("deltas_in_memory") = (double)plan.delta_map_bytes,
+                        Named("deltas_on_disk") = (double)plan.delta_file_bytes,
+                        Named("total_in_memory") = (double)plan.in_memory_bytes,
+                        Named("total_spilled") = (double)plan.spilled_bytes),
+                      Named("budget") = (double)plan.memory_budget,
+                      Named("spills") = plan.will_spill,
+                      Named("min_rows") = (double)plan.row_lower_bound,
+                      Named("bound") = plan.bound_reason,
+                      Named("build_seconds") = plan.build_seconds,
+                      Named("row_seconds") = plan.row_seconds,
+                      Named("feasible") = plan.feasible,
+                      Named("reason") = plan.reason);
+}
+
+//sizes what generateLA() would build with the same levels, t, d, and delta, without building any of it;
+//memory is the budget in MB (0 for the default of half the machine's memory); sizes are in bytes
+// [[Rcpp::export(planLA)]]
+List plan_array_r(IntegerVector levels, int t = 2, int d = 0, int delta = 0, double memory = 0){
+  Parser p;
+  set_up_parser(&p, levels, t, d, delta);
+  if (memory > 0) p.memory_budget = (uint64_t)(memory*1024*1024);
+  return plan_list(plan_array(&p));
+}
+
+//sizes the job a processed parser describes, as --plan does in main(); same list as planLA()
+List parser_plan(Parser* p){
+  return plan_list(plan_array(p));
+}
+
+//status of a background job as a named list; safe to call while the job is running
+List job_status(Job* job){
+  static const char *states[] = {"pending", "running", "finished", "stuck", "cancelled", "failed"};
+  Job_Status s = job->status();
+  return List::create(Named("state") = states[s.state],
+                      Named("rows") = (double)s.rows,
+                      Named("score") = (double)s.score,
+                      Named("coverage") = (double)s.c_score,
+                      Named("location") = (double)s.l_score,
+                      Named("detection") = (double)s.d_score,
+                      Named("heuristic") = s.heuristic,
+                      Named("elapsed") = s.elapsed_seconds,
+                      Named("error") = s.error);
+}
+
+//finished array of a background job; the job keeps ownership of the Array itself
+IntegerMatrix job_result(Job* job){
+  Array *ar = job->result();
+  if (!ar) stop("the job has not finished; check status() or call wait() first");
+  return array_to_matrix(ar);
+}
+
 
 RCPP_MODULE(Parser_module){
   class_<Parser>("Parser")
@@ -32,6 +275,14 @@ RCPP_MODULE(Parser_module){
   .method("get_d", &Parser::get_d)
   .method("get_t", &Parser::get_t)
   .method("get_delta", &Parser::get_delta)
+  .method("get_seed", &Parser::get_seed)
+  .method("get_ipog", &Parser::get_ipog)
+  .method("get_extend", &Parser::get_extend)
+  .method("get_exact", &Parser::get_exact)
+  .method("get_shrink", &Parser::get_shrink)
+  .method("get_plan", &Parser::get_plan)
+  .method("plan", &parser_plan)
+  .method("get_batch", &Parser::get_batch)
   .method("getArray",&Parser::getArray);
 }
 
@@ -45,6 +296,29 @@ RCPP_MODULE(Array_module){
   .method("add_row_uint16", static_cast<void (Array::*)(uint16_t*)>(&Array::add_row))
   // Expose the add_row method with no arguments as "add_row_no_args"
   .method("add_row_no_args", static_cast<void (Array::*)()>(&Array::add_row))
+  .method("add_seed", &Array::add_seed)
+  .method("add_ipog", &Array::add_ipog)
+  .method("add_rows", &Array::add_rows)
+  .method("verify", &Array::verify)
+  .method("to_matrix", &array_to_matrix)
+  .method("load_matrix", &array_load_matrix)
+  .method("extend_rows", &array_extend_rows)
+  .method("complete", &array_complete)
+  .method("upgrade", &array_upgrade)
+  .method("set_strategies", &Array::set_strategies)
+  .method("strategy_stats", &array_strategy_stats)
+  .method("session_memory_stats", &session_memory_stats)
+  .method("shrink", &Array::shrink)
+  .method("solve_exact", &Array::solve_exact)
   .method("getOut_of_Memory",&Array::getOut_of_Memory);
+
+  class_<Job>("Job")
+  .constructor<Parser*>()
+  .method("start", &Job::start)
+  .method("cancel", &Job::cancel)
+  .method("done", &Job::done)
+  .method("wait", &Job::wait)
+  .method("status", &job_status)
+  .method("result", &job_result);
 }
 
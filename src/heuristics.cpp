@@ -9,9 +9,11 @@ Last updated 12/30/2022
 */
 
 #include "array.h"
+#include "strategy.h"
 #include <sstream>
 #include <unistd.h>
 #include <algorithm>
+#include <time.h>
 #include <Rcpp.h>
 #include <RcppCommmon.h>
 
@@ -25,57 +27,32 @@ using namespace Rcpp;
 */
 void Array::add_row()
 {
-    // choose a new random order for the column iterations this round
-    for (uint16_t size = num_factors; size > 0; size--) {
-        uint16_t rand_idx = rand() % size;
-        uint16_t temp = permutation[size - 1];
-        permutation[size - 1] = permutation[rand_idx];
-        permutation[rand_idx] = temp;
-    }   // at this point, permutation should be shuffled
-
-    // choose how to initialize the new row based on current heuristic to be used
-    uint16_t *new_row;
-    Interaction *locked_interaction = nullptr;
-    T *locked_set = nullptr;
-    switch (heuristic_in_use) {
-        case c_only:
-        case c_and_l:
-        case c_and_d:
-            new_row = initialize_row_S();
-            heuristic_c_only(new_row);
-            break;
-        case l_only:
-            new_row = initialize_row_T(&locked_set, &locked_interaction);
-            heuristic_l_only(new_row, locked_set, locked_interaction);
-            break;
-        case l_and_d:
-            new_row = initialize_row_I(&locked_interaction);
-            heuristic_l_and_d(new_row, locked_interaction);
-            break;
-        case d_only:
-            new_row = initialize_row_R(&locked_interaction);
-            if (!heuristic_all(new_row, locked_interaction)) {
-                report_out_of_memory();
-                //if (some flag) don't actually stop
-                return;
-            }
-            break;
-        case all:
-            new_row = initialize_row_R();
-            if (!heuristic_all(new_row)) {
-                report_out_of_memory();
-                // if (some flag) don't actually stop
-                return;
-            }
-            break;
-        case none:
-        default:
-            new_row = initialize_row_R();
-            break;
+    clock_t start = clock();    // CPU time over all threads, for the strategy accounting and the scheduler
+    uint64_t prev_score = score;
+    prop_mode used = heuristic_in_use;
+    bool builtin;   // whether the strategy is the one heuristic_in_use stands for
+    Strategy *strategy = choose_strategy(&builtin);     // see strategy.cpp
+
+    // the strategy initializes the new row, then refines it
+    uint16_t *new_row = strategy->initialize();
+    if (!strategy->refine(new_row)) {
+        delete[] new_row;
+        report_out_of_memory();
+        // if (some flag) don't actually stop
+        return;
     }   // at this point, new row should be initialized with values
+    if (cancelled()) {  // the heuristic may have stopped partway through; don't keep a half-chosen row
+        delete[] new_row;
+        return;
+    }
     
     // tweak the row based on the current heuristic and then add to the array
-    update_array(new_row);
+    update_array(new_row, true, true);
+    update_dont_cares();
+    double cpu_seconds = static_cast<double>(clock() - start)/CLOCKS_PER_SEC;
+    charge_strategy(strategy, prev_score, cpu_seconds);
+    if (effort >= 0 && builtin) record_heuristic(used, prev_score, cpu_seconds);
+    update_heuristic();
 }
 
 /* SUB METHOD: add_row - adds a new row to the array
@@ -95,6 +72,175 @@ void Array::add_row(uint16_t *row)
     just_switched_heuristics = true;    // keeps heuristic_all from breaking if called right away
 }
 
+/* SUB METHOD: add_rows - adds k rows to the array, chosen jointly against the current state
+ * - one priority scan ranks all Interactions, then each row in the batch is built around a different
+ *   target that no earlier row in the batch already contains; the whole batch is committed at the end
+ *   with a single don't care and heuristic update
+ * - heuristic_all (and the random first row) gain nothing from batching, so they fall back to add_row(); so
+ *   does a chain of strategies, which is only followed there
+ *
+ * parameters:
+ * - k: number of rows to add
+ *
+ * returns:
+ * - void, but after the method finishes, the array will have up to k new rows appended to its end
+*/
+void Array::add_rows(uint16_t k)
+{
+    if (k <= 1 || !chain.empty() || heuristic_in_use == prop_mode::all || heuristic_in_use == none) {
+        for (uint16_t i = 0; i < k && score > 0 && !out_of_memory; i++) add_row();
+        return;
+    }
+    clock_t start = clock();
+    uint64_t prev_score = score;
+    prop_mode used = heuristic_in_use;
+    shuffle_permutation();
+
+    // single priority scan, same ranking as initialize_row_R(); ties are broken by the shuffle beforehand
+    bool coverage_batch = used == c_only || used == c_and_l || used == c_and_d;
+    std::vector<std::pair<uint64_t, Interaction*>> ranked;
+    for (Interaction *interaction : interactions) {
+        if (coverage_batch && interaction->is_covered) continue;    // already solved for these heuristics
+        uint64_t cur_count = 4*(num_tests - interaction->rows.size());
+        for (Single *s : interaction->singles) cur_count += s->c_issues + s->l_issues + s->d_issues;
+        ranked.push_back({cur_count, interaction});
+    }
+    for (uint64_t size = ranked.size(); size > 1; size--) std::swap(ranked[size-1], ranked[rand() % size]);
+    std::stable_sort(ranked.begin(), ranked.end(),
+        [](const std::pair<uint64_t, Interaction*> &a, const std::pair<uint64_t, Interaction*> &b) {
+            return a.first > b.first;
+        });
+
+    std::set<Interaction*> claimed; // Interactions already present in some row of this batch
+    std::set<T*> claimed_sets;      // T sets already targeted for location by some row of this batch
+    std::vector<uint16_t*> batch;
+    for (auto &kv : ranked) {
+        if (batch.size() == k || cancelled()) break;
+        Interaction *target = kv.second;
+        if (claimed.find(target) != claimed.end()) continue;
+        uint16_t *new_row;
+        switch (used) {
+            case c_only:
+            case c_and_l:
+            case c_and_d:
+                new_row = initialize_row_S();
+                for (Single *s : target->singles) new_row[s->factor] = s->value;
+                pack_row(new_row, target, &ranked, &claimed);
+                break;
+            case l_only: {  // lock the worst unclaimed T set among those containing the target
+                T *l_set = nullptr;
+                for (T *t_set : target->sets)
+                    if (claimed_sets.find(t_set) == claimed_sets.end() &&
+                        (!l_set || conflict_count(t_set) > conflict_count(l_set)))
+                        l_set = t_set;
+                if (!l_set) continue;
+                claimed_sets.insert(l_set);
+                new_row = initialize_row_R();
+                for (Single *s : target->singles) new_row[s->factor] = s->value;
+                heuristic_l_only(new_row, l_set, target);
+                break;
+            }
+            case l_and_d:
+                new_row = initialize_row_R();
+                for (Single *s : target->singles) new_row[s->factor] = s->value;
+                heuristic_l_and_d(new_row, target);
+                break;
+            case d_only:
+            default:
+                new_row = initialize_row_R();
+                for (Single *s : target->singles) new_row[s->factor] = s->value;
+                if (!heuristic_all(new_row, target)) {
+                    delete[] new_row;
+                    for (uint16_t *row : batch) delete[] row;
+                    report_out_of_memory();
+                    return;
+                }
+                break;
+        }
+        std::set<Interaction*> row_interactions;
+        find_row_interactions(new_row, &row_interactions);
+        claimed.insert(row_interactions.begin(), row_interactions.end());
+        batch.push_back(new_row);
+    }
+    if (debug == d_on) printf("==%d== Batch of %llu rows built from one priority scan\n", getpid(),
+        static_cast<unsigned long long>(batch.size()));
+    if (cancelled()) {
+        for (uint16_t *row : batch) delete[] row;
+        return;
+    }
+
+    // commit the whole batch with one bookkeeping pass
+    for (uint16_t *row : batch) update_array(row, true, true);
+    update_dont_cares();
+    double cpu_seconds = static_cast<double>(clock() - start)/CLOCKS_PER_SEC;
+    if (!batch.empty()) {
+        bool builtin;
+        charge_strategy(choose_strategy(&builtin), prev_score, cpu_seconds, batch.size());
+        if (effort >= 0) record_heuristic(used, prev_score, cpu_seconds, batch.size());
+    }
+    update_heuristic();
+    if (batch.empty()) add_row();   // every target was claimed; make sure progress is still possible
+}
+
+/* HELPER METHOD: pack_row - greedily fixes more uncovered Interactions into a row built around a target
+ * - used by add_rows() for the coverage heuristics; walks the ranking once, fixing the columns of every
+ *   uncovered, unclaimed Interaction that agrees with the columns fixed so far
+ *
+ * parameters:
+ * - row: integer array representing the row under construction; the target's columns are already set
+ * - target: the Interaction the row was built around
+ * - ranked: Interactions with their priorities, most urgent first
+ * - claimed: Interactions already present in earlier rows of the batch
+ *
+ * returns:
+ * - void, but after the method finishes, the row may have more columns fixed to uncovered Interactions
+*/
+void Array::pack_row(uint16_t *row, Interaction *target,
+    std::vector<std::pair<uint64_t, Interaction*>> *ranked, std::set<Interaction*> *claimed)
+{
+    bool *fixed = new bool[num_factors]{false};
+    uint16_t num_fixed = 0;
+    for (Single *s : target->singles) {
+        fixed[s->factor] = true;
+        num_fixed++;
+    }
+    for (auto &kv : *ranked) {
+        if (num_fixed == num_factors) break;
+        Interaction *i = kv.second;
+        if (i->is_covered || claimed->find(i) != claimed->end()) continue;
+        bool compatible = true, adds = false;
+        for (Single *s : i->singles) {
+            if (fixed[s->factor] && row[s->factor] != s->value) {
+                compatible = false;
+                break;
+            }
+            if (!fixed[s->factor]) adds = true;
+        }
+        if (!compatible || !adds) continue;
+        for (Single *s : i->singles) {
+            if (!fixed[s->factor]) num_fixed++;
+            fixed[s->factor] = true;
+            row[s->factor] = s->value;
+        }
+    }
+    delete[] fixed;
+}
+
+/* HELPER METHOD: shuffle_permutation - chooses a new random order for the column iterations
+ *
+ * returns:
+ * - void, but after the method finishes, permutation will be shuffled
+*/
+void Array::shuffle_permutation()
+{
+    for (uint16_t size = num_factors; size > 0; size--) {
+        uint16_t rand_idx = rand() % size;
+        uint16_t temp = permutation[size - 1];
+        permutation[size - 1] = permutation[rand_idx];
+        permutation[rand_idx] = temp;
+    }   // at this point, permutation should be shuffled
+}
+
 /* SUB METHOD: initialize_row_R - creates a randomly generated row
  * 
  * returns:
@@ -211,9 +357,9 @@ uint16_t *Array::initialize_row_T(T **l_set, Interaction **l_interaction)
             }
     }
     for (T *t_set : working_sets) {
-        if (t_set->location_conflicts.size() >= worst_count) {      // worse or tied
-            if (t_set->location_conflicts.size() > worst_count) {   // strictly worse
-                worst_count = t_set->location_conflicts.size();
+        if (conflict_count(t_set) >= worst_count) {     // worse or tied
+            if (conflict_count(t_set) > worst_count) {  // strictly worse
+                worst_count = conflict_count(t_set);
                 worst_sets.clear();
             }
             worst_sets.push_back(t_set);
@@ -257,6 +403,11 @@ uint16_t *Array::initialize_row_I(Interaction **locked)
         uint64_t cur_count = 0;
         for (auto &kv : interaction->deltas)
             if (kv.second < delta) cur_count += delta - kv.second;
+        if (delta_matrix) {
+            uint16_t *separations = spilled_deltas(interaction);
+            for (uint64_t idx = 0; idx < sets.size(); idx++)
+                if (separations[idx] < delta) cur_count += delta - separations[idx];
+        }
         if (cur_count >= worst_count) {     // worse or tied
             if (cur_count > worst_count) {  // strictly worse
                 worst_count = cur_count;
@@ -291,7 +442,7 @@ void Array::heuristic_c_only(uint16_t *row)
     for (uint16_t col = 0; col < num_factors; col++) dont_cares_c[col] = dont_cares[col];
 
     std::set<Interaction*> row_interactions;
-    build_row_interactions(row, &row_interactions, 0, t, "");
+    find_row_interactions(row, &row_interactions);
     for (Interaction *i : row_interactions) {
         if (i->rows.size() != 0) {  // Interaction is already covered
             bool can_skip = false;  // don't account for Interactions involving already-completed factors
@@ -327,7 +478,7 @@ void Array::heuristic_c_only(uint16_t *row)
             for (uint16_t i = 1; i < factors[permutation[col]]->level; i++) {   // try every possible value
                 row[permutation[col]] = (row[permutation[col]] + 1) % factors[permutation[col]]->level;
                 std::set<Interaction*> new_interactions;    // get the new Interactions
-                build_row_interactions(row, &new_interactions, 0, t, "");
+                find_row_interactions(row, &new_interactions);
 
                 cur_max = heuristic_c_helper(row, &new_interactions, temp_problems);    // test this change
                 if (cur_max < max_problems) {   // this change improved the score, keep it
@@ -344,13 +495,13 @@ void Array::heuristic_c_only(uint16_t *row)
     }
 
     // last resort, start looking for *anything* that is missing
-    for (uint16_t col = 0; col < num_factors; col++) {  // for all factors
+    for (uint16_t col = 0; col < num_factors && !cancelled(); col++) {  // for all factors
         if (dont_cares_c[permutation[col]] != none) continue;   // no need to check already completed factors
         bool improved = false;
         for (uint16_t i = 0; i < factors[permutation[col]]->level; i++) {   // try every possible value
             row[permutation[col]] = (row[permutation[col]] + 1) % factors[permutation[col]]->level;
             std::set<Interaction*> new_interactions;    // get the new Interactions
-            build_row_interactions(row, &new_interactions, 0, t, "");
+            find_row_interactions(row, &new_interactions);
 
             improved = false;   // see if the change helped
             for (Interaction *interaction : new_interactions)
@@ -430,6 +581,10 @@ void Array::heuristic_l_only(uint16_t *row, T* l_set, Interaction *l_interaction
     for (T *conflict : l_set->location_conflicts)   // for every conflicting T set,
         for (Single *s : conflict->singles) // for every Single in that conflicting set,
             scores.at(s->to_string())++;    // increase the score of that Single
+    if (l_set->conflicts_with_all)  // the set has not occurred yet, so every other set is a conflict
+        for (T *conflict : sets)
+            if (conflict != l_set)
+                for (Single *s : conflict->singles) scores.at(s->to_string())++;
 
     // a larger value in the scores map means the Single is involved in more location conflicts
     for (uint16_t col = 0; col < num_factors; col++) {
@@ -475,6 +630,13 @@ void Array::heuristic_l_and_d(uint16_t *row, Interaction *locked)
         for (Single *s : kv.first->singles)                 // for every Single in that set,
             scores.at(s->to_string()) += delta - kv.second; // increase the score of that Single
     }
+    if (delta_matrix) {     // same, over the spilled row
+        uint16_t *separations = spilled_deltas(locked);
+        for (uint64_t idx = 0; idx < sets.size(); idx++) {
+            if (separations[idx] >= delta) continue;    // also skips T sets the Interaction is part of
+            for (Single *s : sets[idx]->singles) scores.at(s->to_string()) += delta - separations[idx];
+        }
+    }
 
     // a larger value in the scores map means the Single is involved in more sets that need separation
     for (uint16_t col = 0; col < num_factors; col++) {
@@ -510,6 +672,11 @@ bool Array::heuristic_all(uint16_t *row)
 {
     // check if there is even enough memory to use this heuristic
     if (!probe_memory_for_threads()) return false;
+    find_symmetries(nullptr);   // only canonical rows are scored; the choice is mapped back at the end
+    if (num_workers > 1 && partition_count == 1 && score_with_workers(row, nullptr)) {
+        random_symmetric_row(row);
+        return true;
+    }
 
     // get scores for all relevant possible rows
     std::vector<std::thread*> threads;
@@ -518,12 +685,14 @@ bool Array::heuristic_all(uint16_t *row)
         cur_thread->join();
         delete cur_thread;
     }
+    if (cancelled()) return true;   // the caller discards the row
 
     // inspect the scores for the best one(s)
     uint64_t best_score = 0;
     min_positive_score = UINT64_MAX;
     std::vector<std::string> best_rows; // there could be ties for the best
     for (auto &kv : row_scores) {
+        if (kv.second == UINT64_MAX) continue;  // skipped as a symmetric duplicate; scored once that changes
         if (kv.second >= best_score) {  // it was better or it tied
             if (kv.second > best_score) {   // for an even better choice, can stop tracking the previous best
                 best_score = kv.second;
@@ -542,7 +711,11 @@ bool Array::heuristic_all(uint16_t *row)
     for (uint16_t col = 0; col < num_factors; col++)
         choice_ss >> row[col];
     
-    row_scores[best_rows.at(choice)] = delta <= 1 ? 0 : min_positive_score - 1;
+    random_symmetric_row(row);      // the memo below is for the row actually added, not its canonical form
+    std::string row_str = std::to_string(row[0]);
+    for (uint16_t col = 1; col < num_factors; col++)
+        row_str += ' ' + std::to_string(row[col]);
+    row_scores[row_str] = delta <= 1 ? 0 : min_positive_score - 1;
     return true;
 }
 
@@ -561,6 +734,11 @@ bool Array::heuristic_all(uint16_t *row, Interaction *locked)
 {
     // check if there is even enough memory to use this heuristic
     if (!probe_memory_for_threads()) return false;
+    find_symmetries(locked);    // only canonical rows are scored; the choice is mapped back at the end
+    if (num_workers > 1 && partition_count == 1 && score_with_workers(row, locked)) {
+        random_symmetric_row(row);
+        return true;
+    }
 
     // get scores for all relevant possible rows
     std::vector<std::thread*> threads;
@@ -570,6 +748,7 @@ bool Array::heuristic_all(uint16_t *row, Interaction *locked)
         cur_thread->join();
         delete cur_thread;
     }
+    if (cancelled()) return true;   // the caller discards the row
 
     // inspect the scores for the best one(s)
     uint64_t best_score = 0;
@@ -583,12 +762,14 @@ bool Array::heuristic_all(uint16_t *row, Interaction *locked)
             best_rows.push_back(kv.first);  // whether it was better or only a tie, keep track of this row
         }
     }
+    if (best_rows.empty()) return false;    // every candidate was skipped, so there is no row to choose
 
     // choose the row that scored the best (for ties, choose randomly from among those tied for the best)
     uint64_t choice = static_cast<uint64_t>(rand()) % best_rows.size();  // for breaking ties randomly
     std::stringstream choice_ss = std::stringstream(best_rows.at(choice));
     for (uint16_t col = 0; col < num_factors; col++)
         choice_ss >> row[col];
+    random_symmetric_row(row);
     return true;
 }
 
@@ -616,12 +797,18 @@ bool Array::heuristic_all(uint16_t *row, Interaction *locked)
 void Array::heuristic_all_helper(uint16_t *row, uint16_t cur_col, std::vector<std::thread*> *threads,
     Interaction *locked, std::map<std::string, uint64_t> *local_scores)
 {
+    if (cancelled()) return;    // stop starting threads; heuristic_all() notices and gives up
+
     // base case: row represents a unique combination and is ready for scoring
     if (cur_col == num_factors) {
         std::string row_str = std::to_string(row[0]); // string representation of the row
         for (uint16_t col = 1; col < num_factors; col++) row_str += ' ' + std::to_string(row[col]);
-        if (just_switched_heuristics && heuristic_in_use == all) row_scores[row_str] += UINT64_MAX;
-        if (heuristic_in_use == all && row_scores[row_str] < min_positive_score) return;
+        if (!local_scores && heuristic_in_use == all) {  // the memo only describes the unlocked search
+            if (just_switched_heuristics) row_scores[row_str] += UINT64_MAX;
+            if (row_scores[row_str] < min_positive_score) return;
+        }
+        if (has_symmetry && !is_canonical(row)) return; // scores the same as a row that is being scored
+        if (partition_count > 1 && candidate_ordinal++ % partition_count != partition_index) return;
         uint16_t *row_copy = new uint16_t[num_factors]; // must be deleted by thread later
         for (uint16_t col = 0; col < num_factors; col++) row_copy[col] = row[col];
         if (threads->size() == max_threads) {
@@ -682,20 +869,24 @@ void Array::heuristic_all_scorer(uint16_t *row, std::string row_str,
     if (row_str.compare("dummy") == 0) return;  // see method header for explanation
 
     // current thread will work with unique copies of the data structures being modified
-    Array *copy = nullptr;
-    while (!copy) copy = clone();   // if out of memory, try waiting for other threads to finish
-    copy->update_array(row, false); // see how all scores, etc., would change
-
-    // define the row score to be the combination of net changes below, weighted by importance
     uint64_t row_score = 0;
-    for (Single *this_s : singles) { // improve the score based on individual Single improvement
-        Single *copy_s = copy->single_map.at(this_s->to_string());
-        uint64_t weight = static_cast<uint64_t>(factors[this_s->factor]->level);    // higher level factors hold more weight
-        row_score += (this_s->c_issues - copy_s->c_issues)*weight/3;
-        row_score += (this_s->l_issues - copy_s->l_issues)*weight/2;
-        row_score += (this_s->d_issues - copy_s->d_issues)*weight;
+    {
+        Memory_Clone_Scope scope;   // the copy is counted apart from this Array (see memory.h)
+        Array *copy = nullptr;
+        while (!copy) copy = clone();   // if out of memory, try waiting for other threads to finish
+        copy->update_array(row, false); // see how all scores, etc., would change
+
+        // define the row score to be the combination of net changes below, weighted by importance
+        for (Single *this_s : singles) { // improve the score based on individual Single improvement
+            Single *copy_s = copy->single_map.at(this_s->to_string());
+            // higher level factors hold more weight
+            uint64_t weight = static_cast<uint64_t>(factors[this_s->factor]->level);
+            row_score += (this_s->c_issues - copy_s->c_issues)*weight/3;
+            row_score += (this_s->l_issues - copy_s->l_issues)*weight/2;
+            row_score += (this_s->d_issues - copy_s->d_issues)*weight;
+        }
+        delete copy;
     }
-    delete copy;
 
     if (debug == d_on) {
         std::stringstream thread_output;
@@ -727,6 +918,7 @@ void Array::heuristic_all_scorer(uint16_t *row, std::string row_str,
 */
 bool Array::probe_memory_for_threads()
 {
+    Memory_Clone_Scope scope;   // the copy is counted apart from this Array (see memory.h)
     Array *copy = clone();  // this operation will have to be performed by at least one thread at a time
     if (!copy) return false;
 
@@ -0,0 +1,232 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds the in-parameter-order (IPOG) engine. Rather than choosing whole rows one at a     |
+| time, it builds a t-way covering array one column at a time: the first t columns get every combination   |
+| of their values, and each later column is added by horizontal growth (giving every existing row the      |
+| value for the new column that covers the most t-way combinations not yet covered) and then vertical       |
+| growth (adding rows for whatever the existing ones cannot cover). Only combinations involving the new     |
+| column are tracked, in one bitmap per column, so no row ever has to be scored against every Interaction. |
+| Cells no combination needs are left as don't cares, so vertical growth can still use them; any left at    |
+| the end get a value cycling with the row number. Columns are added in order of decreasing levels, which  |
+| keeps the first t columns' product as small as it can be. The rows are then loaded through the bulk path; |
+| for coverage alone that finishes the array, and otherwise the heuristics in heuristics.cpp fix whatever   |
+| location and detection issues remain, as with the algebraic seed in seed.cpp.                            |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <algorithm>
+#include <numeric>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// marks a cell no combination has needed yet
+#define IPOG_ANY UINT16_MAX
+
+// tiny helper class for the combinations involving the column being added; each set of t-1 earlier columns
+// (a "partner" set) owns a run of bits, one per combination of its values and a value of the new column
+class Column_Cover
+{
+    public:
+        // the new column, its number of levels, and the levels of every column (in build order)
+        uint16_t col = 0, level = 0;
+        const std::vector<uint16_t> *levels = nullptr;
+
+        // partner sets, t-1 columns each and laid out contiguously, and where each one's run of bits begins
+        uint16_t width = 0;
+        std::vector<uint16_t> partners;
+        std::vector<uint64_t> offsets;
+
+        // one bit per combination, set while the combination is not covered
+        std::vector<uint64_t> uncovered;
+        uint64_t remaining = 0;
+
+        Column_Cover(const std::vector<uint16_t> *levels, uint16_t col, uint16_t t);
+        uint64_t index(const uint16_t *row, uint64_t set, uint16_t value) const;
+        uint64_t gain(const uint16_t *row, uint16_t value) const;
+        void cover(const uint16_t *row);
+        void decode(uint64_t bit, uint16_t *row) const;
+};
+
+/* CONSTRUCTOR - lists every partner set of the new column, and marks every combination uncovered
+ *
+ * parameters:
+ * - levels: levels of every column, in build order
+ * - col: the new column; the columns before it are already complete
+ * - t: strength of the array
+*/
+Column_Cover::Column_Cover(const std::vector<uint16_t> *levels, uint16_t col, uint16_t t) :
+    col(col), level((*levels)[col]), levels(levels), width(t - 1)
+{
+    std::vector<uint16_t> cur(width);
+    std::iota(cur.begin(), cur.end(), 0);
+    uint64_t total = 0;
+    while (true) {
+        uint64_t size = level;
+        for (uint16_t c : cur) size *= (*levels)[c];
+        partners.insert(partners.end(), cur.begin(), cur.end());
+        offsets.push_back(total);
+        total += size;
+        // next set of width columns out of the first col, in lexicographic order
+        int32_t j = width - 1;
+        while (j >= 0 && cur[j] == col - width + j) j--;
+        if (j < 0) break;
+        cur[j]++;
+        for (uint16_t k = j + 1; k < width; k++) cur[k] = cur[k - 1] + 1;
+    }
+    offsets.push_back(total);
+    uncovered.assign((total + 63)/64, ~0ULL);
+    if (total % 64 != 0) uncovered.back() = (1ULL << (total % 64)) - 1;
+    remaining = total;
+}
+
+/* HELPER METHOD: index - finds the bit of the combination a row would have with the given new value
+ *
+ * returns:
+ * - the bit's position, or UINT64_MAX when the row has a don't care in one of the partner set's columns
+*/
+uint64_t Column_Cover::index(const uint16_t *row, uint64_t set, uint16_t value) const
+{
+    uint64_t code = 0;
+    for (uint16_t k = 0; k < width; k++) {
+        uint16_t c = partners[set*width + k];
+        if (row[c] == IPOG_ANY) return UINT64_MAX;
+        code = code*(*levels)[c] + row[c];
+    }
+    return offsets[set] + code*level + value;
+}
+
+uint64_t Column_Cover::gain(const uint16_t *row, uint16_t value) const
+{
+    uint64_t count = 0;
+    for (uint64_t set = 0; set + 1 < offsets.size(); set++) {
+        uint64_t bit = index(row, set, value);
+        if (bit != UINT64_MAX) count += (uncovered[bit/64] >> (bit % 64)) & 1;
+    }
+    return count;
+}
+
+void Column_Cover::cover(const uint16_t *row)
+{
+    if (row[col] == IPOG_ANY) return;
+    for (uint64_t set = 0; set + 1 < offsets.size(); set++) {
+        uint64_t bit = index(row, set, row[col]);
+        if (bit == UINT64_MAX || !((uncovered[bit/64] >> (bit % 64)) & 1)) continue;
+        uncovered[bit/64] &= ~(1ULL << (bit % 64));
+        remaining--;
+    }
+}
+
+/* HELPER METHOD: decode - writes the combination a bit stands for into a row, leaving other cells alone
+*/
+void Column_Cover::decode(uint64_t bit, uint16_t *row) const
+{
+    uint64_t set = std::upper_bound(offsets.begin(), offsets.end(), bit) - offsets.begin() - 1;
+    uint64_t local = bit - offsets[set];
+    row[col] = local % level;
+    local /= level;
+    for (uint16_t k = width; k > 0; k--) {
+        uint16_t c = partners[set*width + k - 1];
+        row[c] = local % (*levels)[c];
+        local /= (*levels)[c];
+    }
+}
+
+/* SUB METHOD: add_ipog - fills an empty array with a t-way covering array built one column at a time
+ * - only does anything when the array has no rows yet
+ *
+ * returns:
+ * - the number of rows added to the array
+*/
+uint64_t Array::add_ipog()
+{
+    if (num_tests != 0 || num_factors < t || t == 0) return 0;
+
+    // build order: by decreasing levels, ties keeping their original order
+    std::vector<uint16_t> order(num_factors);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&](uint16_t a, uint16_t b) { return factors[a]->level > factors[b]->level; });
+    std::vector<uint16_t> levels;
+    for (uint16_t col : order) levels.push_back(factors[col]->level);
+
+    // every combination of the first t columns
+    std::vector<uint16_t*> block;
+    std::vector<uint16_t> combo(t, 0);
+    do {
+        uint16_t *row = new uint16_t[num_factors];
+        std::fill(row, row + num_factors, IPOG_ANY);
+        std::copy(combo.begin(), combo.end(), row);
+        block.push_back(row);
+        int32_t j = t - 1;
+        while (j >= 0 && ++combo[j] == levels[j]) combo[j--] = 0;
+        if (j < 0) break;
+    } while (true);
+
+    for (uint16_t col = t; col < num_factors; col++) {
+        Column_Cover cover(&levels, col, t);
+
+        // horizontal growth; a row that would cover nothing new keeps a don't care for vertical growth
+        for (uint16_t *row : block) {
+            uint64_t best_gain = 0;
+            for (uint16_t value = 0; value < levels[col]; value++) {
+                uint64_t cur_gain = cover.gain(row, value);
+                if (cur_gain > best_gain) {
+                    best_gain = cur_gain;
+                    row[col] = value;
+                }
+            }
+            cover.cover(row);
+            if (cover.remaining == 0) break;
+        }
+
+        // vertical growth: each combination still uncovered goes into the first row with room for it, or a
+        // new row of don't cares
+        std::vector<uint16_t> wanted(num_factors);
+        for (uint64_t w = 0; w < cover.uncovered.size(); w++)
+            while (cover.uncovered[w]) {
+                uint64_t bit = w*64 + __builtin_ctzll(cover.uncovered[w]);
+                std::fill(wanted.begin(), wanted.end(), IPOG_ANY);
+                cover.decode(bit, wanted.data());
+                uint16_t *home = nullptr;
+                for (uint16_t *row : block) {
+                    bool fits = true;
+                    for (uint16_t c = 0; c <= col && fits; c++)
+                        fits = wanted[c] == IPOG_ANY || row[c] == IPOG_ANY || row[c] == wanted[c];
+                    if (fits) {
+                        home = row;
+                        break;
+                    }
+                }
+                if (!home) {
+                    home = new uint16_t[num_factors];
+                    std::fill(home, home + num_factors, IPOG_ANY);
+                    block.push_back(home);
+                }
+                for (uint16_t c = 0; c <= col; c++) if (wanted[c] != IPOG_ANY) home[c] = wanted[c];
+                cover.cover(home);
+            }
+        if (debug == d_on) printf("==%d== IPOG: column %hu of %hu added, %llu rows\n", getpid(), col + 1,
+            num_factors, static_cast<unsigned long long>(block.size()));
+    }
+
+    // settle the remaining don't cares, and put the columns back in their original order
+    std::vector<uint16_t> built(num_factors);
+    for (uint64_t r = 0; r < block.size(); r++) {
+        for (uint16_t c = 0; c < num_factors; c++)
+            built[c] = block[r][c] == IPOG_ANY ? r % levels[c] : block[r][c];
+        for (uint16_t c = 0; c < num_factors; c++) block[r][order[c]] = built[c];
+    }
+
+    if (o != silent) printf("Building %llu rows one column at a time (IPOG).\n",
+        static_cast<unsigned long long>(block.size()));
+    load_rows(&block);
+    for (uint16_t *row : block) delete[] row;
+    return block.size();
+}
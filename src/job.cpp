@@ -0,0 +1,160 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Job class, which is declared in job.h. The  |
+| background thread does exactly what main() does (partial rows, optional seed, exact search, then          |
+| Array::complete(), and optional shrinking), publishing a fresh status snapshot after every row. All reads |
+| of the Array happen on that thread, so the only shared state is the snapshot, guarded by a mutex, and the |
+| cancel token, which is atomic.                                                                            |
+|===========================================================================================================|
+*/
+
+#include "parser.h"
+#include "array.h"
+#include "job.h"
+#include <new>
+#include <stdexcept>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+/* CONSTRUCTOR - initializes the object
+ * - the Job does nothing until start() is called
+*/
+Job::Job(Parser *in): p(in), cancel_requested(false)
+{
+}
+
+/* DECONSTRUCTOR - frees memory
+ * - a Job still running is cancelled first, since the thread refers to this object
+*/
+Job::~Job()
+{
+    cancel();
+    if (worker) {
+        worker->join();
+        delete worker;
+    }
+    delete array;
+}
+
+/* SUB METHOD: start - begins generating the array on a background thread
+ * - calling it again once the Job has started does nothing
+ *
+ * returns:
+ * - void, but after the method finishes, the Job will be running
+*/
+void Job::start()
+{
+    std::lock_guard<std::mutex> lock(status_mutex);
+    if (worker) return;
+    started = std::chrono::steady_clock::now();
+    snapshot.state = job_running;
+    worker = new std::thread(&Job::run, this);
+}
+
+/* SUB METHOD: cancel - asks the background thread to stop
+ * - returns right away; use wait() to know when the thread has actually stopped
+ *
+ * returns:
+ * - void, but after the method finishes, the Array will stop at its next check of the cancel token
+*/
+void Job::cancel()
+{
+    cancel_requested.store(true);
+}
+
+bool Job::done()
+{
+    std::lock_guard<std::mutex> lock(status_mutex);
+    return snapshot.state != job_pending && snapshot.state != job_running;
+}
+
+/* SUB METHOD: wait - blocks until the Job is done
+ *
+ * parameters:
+ * - timeout_seconds: longest to wait; negative (the default) waits for as long as it takes
+ *
+ * returns:
+ * - whether the Job is done (false if it timed out, or was never started)
+*/
+bool Job::wait(double timeout_seconds)
+{
+    std::unique_lock<std::mutex> lock(status_mutex);
+    auto is_done = [this]() { return snapshot.state != job_pending && snapshot.state != job_running; };
+    if (snapshot.state == job_pending) return false;
+    if (timeout_seconds < 0) finished.wait(lock, is_done);
+    else finished.wait_for(lock, std::chrono::duration<double>(timeout_seconds), is_done);
+    return is_done();
+}
+
+Job_Status Job::status()
+{
+    std::lock_guard<std::mutex> lock(status_mutex);
+    Job_Status copy = snapshot;
+    if (snapshot.state != job_pending)
+        copy.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return copy;
+}
+
+Array *Job::result()
+{
+    return done() ? array : nullptr;
+}
+
+/* HELPER METHOD: run - body of the background thread; mirrors main()
+ *
+ * returns:
+ * - void, but after the method finishes, the snapshot will hold the final state
+*/
+void Job::run()
+{
+    try {
+        p->workers = 1;     // never fork the R session, least of all from this thread (see workers.cpp)
+        array = new Array(p);
+        array->set_cancel_token(&cancel_requested);
+        if (p->extend) array->extend_rows(&p->array, p->extend_cols);   // existing rows, adapted to new factors
+        else for (uint64_t r = 0; r < p->array.size(); r++) array->add_row(p->array.row(r).data());
+        if (p->seed) array->add_seed();
+        if (p->ipog) array->add_ipog();
+        publish(job_running);
+        if (array->score > 0 && p->exact > 0) array->solve_exact(p->exact);    // leaves the array as is if not
+        bool success = array->score == 0 || array->complete(p->batch, [this]() { publish(job_running); });
+        if (success && p->shrink > 0) array->shrink(p->shrink);  // then fewer rows
+        if (cancel_requested.load()) publish(job_cancelled);
+        else if (array->out_of_memory) publish(job_failed, "ran out of memory for the current heuristic");
+        else publish(success ? job_finished : job_stuck);
+    } catch (const std::bad_alloc &e) {
+        publish(job_failed, "ran out of memory while building the array");
+    } catch (const std::exception &e) {
+        publish(job_failed, e.what());
+    }
+}
+
+/* HELPER METHOD: publish - refreshes the status snapshot from the Array
+ *  --> only called on the background thread, which is the only one touching the Array
+ *
+ * parameters:
+ * - state: the Job's state as of this call
+ * - error: description of what went wrong, when state is job_failed
+ *
+ * returns:
+ * - void, but after the method finishes, the snapshot is current, and waiters are woken if the Job is done
+*/
+void Job::publish(job_state state, const std::string &error)
+{
+    Job_Status fresh;
+    fresh.state = state;
+    fresh.error = error;
+    if (array) {
+        fresh.rows = array->getNum_Tests();
+        fresh.score = array->score;
+        array->getScore_Breakdown(&fresh.c_score, &fresh.l_score, &fresh.d_score);
+        fresh.heuristic = array->getHeuristic();
+    }
+    std::lock_guard<std::mutex> lock(status_mutex);
+    snapshot = fresh;
+    if (state != job_running) finished.notify_all();
+}
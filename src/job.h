@@ -0,0 +1,108 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains a class for running a whole array generation on a background thread. It is meant   |
+| for the R interface, where driving the loop from R blocks the session until the array is finished. A Job |
+| is created from a Parser that has already had its process_input() method called, then started; from then |
+| on, the caller can poll its status, ask it to cancel, wait on it, and finally take the finished Array.   |
+| Cancellation is cooperative: the Array checks the Job's token between rows and inside the heuristics, so |
+| even a long heuristic_all() call stops starting new work shortly after cancel() is called; the one thing |
+| that cannot be interrupted is the Array's constructor. The Parser must outlive the Job.                   |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef JOB
+#define JOB
+
+#include <stdint.h>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class Parser;   // forward declarations; array.h has no include guard, so it is left to the source files
+class Array;
+
+// typedef representing where a Job is in its life cycle
+// - job_pending has not been started yet
+// - job_running is generating rows on the background thread
+// - job_finished completed the array with all requested properties
+// - job_stuck stopped because the array stopped improving (the same condition main() warns about)
+// - job_cancelled stopped early because cancel() was called
+// - job_failed ran into an error, described by Job_Status::error
+typedef enum {
+    job_pending     = 0,
+    job_running     = 1,
+    job_finished    = 2,
+    job_stuck       = 3,
+    job_cancelled   = 4,
+    job_failed      = 5
+} job_state;
+
+// a copy of a Job's progress, taken under the Job's lock so it can be read while the Job keeps running
+class Job_Status
+{
+    public:
+        job_state state = job_pending;
+
+        // rows in the array so far
+        uint64_t rows = 0;
+
+        // total score, and the part of it remaining in each category
+        uint64_t score = 0;
+        uint64_t c_score = 0, l_score = 0, d_score = 0;
+
+        // heuristic the Array will use for its next row
+        std::string heuristic;
+
+        // wall clock time since start() was called
+        double elapsed_seconds = 0;
+
+        // filled in when state is job_failed
+        std::string error;
+};
+
+class Job
+{
+    public:
+        void start();               // builds the Array and adds rows on a background thread
+        void cancel();              // asks the background thread to stop at its next check
+        bool done();                // whether the background thread has stopped, for whatever reason
+        bool wait(double timeout_seconds = -1); // blocks until done or timed out; negative means no timeout
+        Job_Status status();        // snapshot of progress so far
+        Array *result();            // the Array once done (nullptr before then); still owned by the Job
+        Job(Parser *in);            // constructor with a Parser whose process_input() method has been called
+        ~Job();                     // cancels and joins the background thread if still running
+
+    private:
+        // where the settings come from; not owned
+        Parser *p;
+
+        // built on the background thread, since construction alone can take a while for large inputs
+        Array *array = nullptr;
+
+        // the background thread, once started
+        std::thread *worker = nullptr;
+
+        // checked by the Array while generating
+        std::atomic<bool> cancel_requested;
+
+        // protects snapshot, and signals waiters when the Job is done
+        std::mutex status_mutex;
+        std::condition_variable finished;
+
+        // last published progress
+        Job_Status snapshot;
+
+        // when start() was called, for elapsed_seconds
+        std::chrono::steady_clock::time_point started;
+
+        void run();                 // body of the background thread
+        void publish(job_state state, const std::string &error = "");   // refreshes the snapshot
+};
+
+#endif // JOB
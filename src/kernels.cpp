@@ -0,0 +1,212 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds fixed-strength kernels for the cases nearly every job uses: t of 2 or 3, and d of |
+| 1 or 2. The general methods in array.cpp recurse over a runtime t or d and push and pop a vector at each  |
+| level; finding a row's Interactions that way also builds a string key per Interaction and looks it up in |
+| interaction_map. The kernels here are plain nested loops instead, and find a row's Interactions by their |
+| index, which follows from the order the Interactions are built in (by leading Single, then recursively by |
+| the rest): the rank tables give where each leading Single's Interactions start, and the rest is an offset |
+| within that run. Other values of t and d still go through the recursive methods.                          |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+/* HELPER METHOD: build_rank_tables - works out where each leading Single's Interactions start
+ * - must be called after the interactions vector is built, in the order build_t_way_interactions() uses
+ * - rank_pair[f] is the index of the first 2-way Interaction led by the Single with flat position f (see
+ *   single_offsets()), counting only Interactions over that Single's column and those after it; rank_triple
+ *   is the same for 3-way Interactions; both have one extra entry at the end holding the total
+ *
+ * returns:
+ * - void, but after the method finishes, the tables find_row_interactions() needs will be filled in
+*/
+void Array::build_rank_tables()
+{
+    rank_offset = single_offsets();
+    uint64_t num_singles = rank_offset.back();
+    rank_pair.assign(num_singles + 1, 0);
+    rank_triple.assign(num_singles + 1, 0);
+    for (uint16_t col = 0; col < num_factors; col++)
+        for (uint16_t level = 0; level < factors[col]->level; level++) {
+            uint64_t f = rank_offset[col] + level;
+            rank_pair[f + 1] = rank_pair[f] + num_singles - rank_offset[col + 1];
+        }
+    for (uint16_t col = 0; col < num_factors; col++)
+        for (uint16_t level = 0; level < factors[col]->level; level++) {
+            uint64_t f = rank_offset[col] + level;
+            rank_triple[f + 1] = rank_triple[f] + rank_pair[num_singles] - rank_pair[rank_offset[col + 1]];
+        }
+}
+
+/* SUB METHOD: find_row_interactions - recovers the Interaction objects that occur in a row
+ * - uses the fixed-strength kernel for t of 2 or 3, and build_row_interactions() otherwise
+ *
+ * parameters:
+ * - row: integer array representing a row up for consideration for appending to the array
+ * - row_interactions: initially empty set to hold the Interactions as they are recovered
+ *
+ * returns:
+ * - void, but after the method finishes, the row_interactions set will hold all the interactions in the row
+*/
+void Array::find_row_interactions(uint16_t *row, std::set<Interaction*> *row_interactions)
+{
+    if (t == 2 && !rank_pair.empty()) row_interactions_fixed<2>(row, row_interactions);
+    else if (t == 3 && !rank_triple.empty()) row_interactions_fixed<3>(row, row_interactions);
+    else build_row_interactions(row, row_interactions, 0, t, "");
+}
+
+template <>
+void Array::row_interactions_fixed<2>(uint16_t *row, std::set<Interaction*> *row_interactions)
+{
+    for (uint16_t c1 = 0; c1 + 1 < num_factors; c1++) {
+        uint64_t base = rank_pair[rank_offset[c1] + row[c1]] - rank_offset[c1 + 1];
+        for (uint16_t c2 = c1 + 1; c2 < num_factors; c2++)
+            row_interactions->insert(interactions[base + rank_offset[c2] + row[c2]]);
+    }
+}
+
+template <>
+void Array::row_interactions_fixed<3>(uint16_t *row, std::set<Interaction*> *row_interactions)
+{
+    for (uint16_t c1 = 0; c1 + 2 < num_factors; c1++) {
+        // the pairs after column c1 are ranked as if the columns before it did not exist
+        uint64_t base1 = rank_triple[rank_offset[c1] + row[c1]] - rank_pair[rank_offset[c1 + 1]];
+        for (uint16_t c2 = c1 + 1; c2 + 1 < num_factors; c2++) {
+            uint64_t base2 = base1 + rank_pair[rank_offset[c2] + row[c2]] - rank_offset[c2 + 1];
+            for (uint16_t c3 = c2 + 1; c3 < num_factors; c3++)
+                row_interactions->insert(interactions[base2 + rank_offset[c3] + row[c3]]);
+        }
+    }
+}
+
+/* HELPER METHOD: interactions_fixed - makes every t-way Interaction led by the given Single, for t of 2 or 3
+ * - the Interactions are made in the order build_t_way_interactions() would make them, but are not added
+ *   to the Array; the caller does that
+ *
+ * parameters:
+ * - lead: Single in the lowest column of each Interaction
+ * - out: vector to append the new Interactions to
+ *
+ * returns:
+ * - void, but after the method finishes, out will hold the new Interactions
+*/
+template <>
+void Array::interactions_fixed<2>(Single *lead, std::vector<Interaction*> *out)
+{
+    std::vector<Single*> temp(2, lead);
+    for (uint16_t c2 = lead->factor + 1; c2 < num_factors; c2++)
+        for (uint16_t v2 = 0; v2 < factors[c2]->level; v2++) {
+            temp[1] = factors[c2]->singles[v2];
+            out->push_back(new Interaction(&temp));
+        }
+}
+
+template <>
+void Array::interactions_fixed<3>(Single *lead, std::vector<Interaction*> *out)
+{
+    std::vector<Single*> temp(3, lead);
+    for (uint16_t c2 = lead->factor + 1; c2 + 1 < num_factors; c2++)
+        for (uint16_t v2 = 0; v2 < factors[c2]->level; v2++) {
+            temp[1] = factors[c2]->singles[v2];
+            for (uint16_t c3 = c2 + 1; c3 < num_factors; c3++)
+                for (uint16_t v3 = 0; v3 < factors[c3]->level; v3++) {
+                    temp[2] = factors[c3]->singles[v3];
+                    out->push_back(new Interaction(&temp));
+                }
+        }
+}
+
+/* HELPER METHOD: sets_fixed - makes every size-d T set led by the given Interaction, for d of 1 or 2
+ * - the T sets are made in the order build_size_d_sets() would make them, but are not added to the Array
+ *
+ * parameters:
+ * - lead: index in the interactions vector of the first Interaction of each T set
+ * - out: vector to append the new T sets to
+ * - link: whether to add each T set to its Interactions' sets (see the T constructor)
+ *
+ * returns:
+ * - void, but after the method finishes, out will hold the new T sets
+*/
+template <>
+void Array::sets_fixed<1>(uint64_t lead, std::vector<T*> *out, bool link)
+{
+    std::vector<Interaction*> temp(1, interactions[lead]);
+    out->push_back(new T(&temp, link));
+}
+
+template <>
+void Array::sets_fixed<2>(uint64_t lead, std::vector<T*> *out, bool link)
+{
+    std::vector<Interaction*> temp(2, interactions[lead]);
+    for (uint64_t i2 = lead + 1; i2 < interactions.size(); i2++) {
+        temp[1] = interactions[i2];
+        out->push_back(new T(&temp, link));
+    }
+}
+
+/* HELPER METHOD: enumerate_interactions - serial counterpart of build_interactions(), used by clone()
+ * - same result as build_t_way_interactions(0, t, ...), using the fixed kernels when t is 2 or 3
+ *
+ * returns:
+ * - void, but after the method finishes, the interactions vector and map, and the rank tables, will be set
+*/
+void Array::enumerate_interactions()
+{
+    if (t != 2 && t != 3) {
+        std::vector<Single*> temp_singles;
+        build_t_way_interactions(0, t, &temp_singles);
+        build_rank_tables();
+        return;
+    }
+    std::vector<Interaction*> made;
+    for (uint16_t col = 0; col + t <= num_factors; col++)
+        for (uint16_t level = 0; level < factors[col]->level; level++) {
+            if (t == 2) interactions_fixed<2>(factors[col]->singles[level], &made);
+            else interactions_fixed<3>(factors[col]->singles[level], &made);
+        }
+    for (Interaction *new_interaction : made) {
+        new_interaction->index = interactions.size();
+        interactions.push_back(new_interaction);
+        interaction_map.insert({new_interaction->to_string(), new_interaction});
+        for (Single *single : new_interaction->singles) {
+            factors[single->factor]->c_issues++;
+            single->c_issues++;
+            total_problems++;
+            score++;
+        }
+    }
+    build_rank_tables();
+}
+
+/* HELPER METHOD: enumerate_sets - serial counterpart of build_sets(), used by clone()
+ * - same result as build_size_d_sets(0, d, ...), using the fixed kernels when d is 1 or 2
+ *
+ * returns:
+ * - void, but after the method finishes, the sets vector and map will be initialized
+*/
+void Array::enumerate_sets()
+{
+    if (d != 1 && d != 2) {
+        std::vector<Interaction*> temp_interactions;
+        build_size_d_sets(0, d, &temp_interactions);
+        return;
+    }
+    std::vector<T*> made;
+    for (uint64_t lead = 0; lead + d <= interactions.size(); lead++) {
+        if (d == 1) sets_fixed<1>(lead, &made, true);
+        else sets_fixed<2>(lead, &made, true);
+    }
+    for (T *new_set : made) {
+        new_set->index = sets.size();
+        sets.push_back(new_set);
+        t_set_map.insert({new_set->to_string(), new_set});
+    }
+}
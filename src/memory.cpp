@@ -0,0 +1,151 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for the functions and the Memory_Clone_Scope class declared in memory.h, |
+| and for the methods of the Array class that report the counts. Each thread keeps its changes to the counts |
+| in a thread_local batch, which is passed on to the shared atomic counts once it drifts far enough, when   |
+| the counts are read from that thread, and when the thread exits; so the peaks can be off by at most one  |
+| batch per running thread, which keeps every allocation from contending for the same atomic.              |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <atomic>
+#include <algorithm>
+#include <stdlib.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// the shared counts; the peak of the total is kept apart from the families' peaks, which need not coincide
+static std::atomic<int64_t> live_bytes[mem_families];
+static std::atomic<int64_t> peak_bytes[mem_families];
+static std::atomic<int64_t> live_total(0);
+static std::atomic<int64_t> peak_total(0);
+
+// whether the thread is inside a Memory_Clone_Scope
+static thread_local bool in_clone = false;
+
+// method forward declarations
+static void raise_peak(std::atomic<int64_t> *peak, int64_t value);
+
+// tiny helper class for a thread's changes not yet passed on to the shared counts
+class Memory_Batch
+{
+    public:
+        int64_t pending[mem_families] = {};
+
+        void flush(mem_family family)
+        {
+            if (pending[family] == 0) return;
+            int64_t now = live_bytes[family].fetch_add(pending[family]) + pending[family];
+            raise_peak(&peak_bytes[family], now);
+            raise_peak(&peak_total, live_total.fetch_add(pending[family]) + pending[family]);
+            pending[family] = 0;
+        }
+
+        void flush()
+        {
+            for (uint8_t family = 0; family < mem_families; family++) flush(static_cast<mem_family>(family));
+        }
+
+        ~Memory_Batch() { flush(); }
+};
+
+static thread_local Memory_Batch batch;
+
+/* UTILITY METHOD: memory_note - adds to the live count of a family, from the calling thread
+ *
+ * parameters:
+ * - family: family the bytes belong to; inside a Memory_Clone_Scope, they belong to the clones instead
+ * - bytes: bytes allocated, or negative for bytes freed
+ *
+ * returns:
+ * - void, but after the method finishes, the bytes will be counted (once the thread's batch is passed on)
+*/
+void memory_note(mem_family family, int64_t bytes)
+{
+    if (in_clone) family = mem_clones;
+    batch.pending[family] += bytes;
+    if (llabs(batch.pending[family]) >= MEMORY_BATCH_BYTES) batch.flush(family);
+}
+
+uint64_t memory_live(mem_family family)
+{
+    batch.flush(family);
+    return static_cast<uint64_t>(std::max<int64_t>(live_bytes[family].load(), 0));
+}
+
+uint64_t memory_peak(mem_family family)
+{
+    batch.flush(family);
+    return static_cast<uint64_t>(std::max<int64_t>(peak_bytes[family].load(), 0));
+}
+
+uint64_t memory_live_total()
+{
+    batch.flush();
+    return static_cast<uint64_t>(std::max<int64_t>(live_total.load(), 0));
+}
+
+uint64_t memory_peak_total()
+{
+    batch.flush();
+    return static_cast<uint64_t>(std::max<int64_t>(peak_total.load(), 0));
+}
+
+const char *memory_family_name(mem_family family)
+{
+    static const char *names[mem_families] = {"Singles", "Interactions", "Interaction rows", "T sets",
+        "T set rows", "Location conflicts", "Detection deltas", "String maps", "Row scores", "Rows",
+        "Clones"};
+    return names[family];
+}
+
+// a string keeps short contents inline; only a longer one's buffer is on the heap
+uint64_t heap_bytes(const std::string &str)
+{
+    return str.capacity() > std::string().capacity() ? str.capacity() + 1 : 0;
+}
+
+/* CONSTRUCTOR - starts counting the thread's allocations as part of a clone
+*/
+Memory_Clone_Scope::Memory_Clone_Scope() : outer(in_clone)
+{
+    in_clone = true;
+}
+
+/* DECONSTRUCTOR - goes back to counting the thread's allocations as before
+*/
+Memory_Clone_Scope::~Memory_Clone_Scope()
+{
+    in_clone = outer;
+}
+
+/* UTILITY METHOD: print_memory - outputs the live and peak bytes of every family that has held any
+ *
+ * returns:
+ * - void, but after the method finishes, one line per family will have been printed
+*/
+void Array::print_memory()
+{
+    printf("\nMemory (MB, live / peak):\n");
+    for (uint8_t f = 0; f < mem_families; f++) {
+        mem_family family = static_cast<mem_family>(f);
+        if (memory_peak(family) == 0) continue;
+        printf("\t- %s: %.2f / %.2f\n", memory_family_name(family), memory_live(family)/1048576.0,
+            memory_peak(family)/1048576.0);
+    }
+    printf("\t- Total: %.2f / %.2f\n", memory_live_total()/1048576.0, memory_peak_total()/1048576.0);
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+// raises an atomic peak to value, if it is higher
+static void raise_peak(std::atomic<int64_t> *peak, int64_t value)
+{
+    int64_t cur = peak->load();
+    while (value > cur && !peak->compare_exchange_weak(cur, value)) {}
+}
@@ -0,0 +1,106 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains the live byte counts kept for the Array's structures. Each structure family has a  |
+| live count and the highest that count has reached. The containers that grow while rows are added (the row |
+| sets, location conflicts, deltas, string maps, and memoized row scores) use Counting_Allocator, so their  |
+| counts are exact to the byte that was requested. The fixed parts of the Singles, Interactions, and T sets |
+| (the objects, their vectors, and their strings) are counted by their constructors and destructors. The    |
+| rows are counted by the allocator of the Row_Matrix holding them (see rows.h). Map keys longer than a     |
+| std::string keeps inline are not counted, nor is allocator overhead. Whatever is allocated by a thread    |
+| inside a Memory_Clone_Scope goes to the clone family instead, so the copies heuristic_all() works on are  |
+| seen apart from the Array itself. The counts are kept per process, so with several Arrays alive they add  |
+| up. Each thread batches its changes, and only passes them on to the shared counts every                   |
+| MEMORY_BATCH_BYTES.                                                                                       |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef MEMORY
+#define MEMORY
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <memory>
+#include <set>
+#include <map>
+
+// bytes a thread's count may drift from the shared one before it is passed on
+#define MEMORY_BATCH_BYTES 65536
+
+// typedef representing the families of structures whose bytes are counted
+typedef enum {
+    mem_singles             = 0,    // Singles and the sets of rows they occur in
+    mem_interactions        = 1,    // Interactions, and the sets of T sets they are part of
+    mem_interaction_rows    = 2,    // the sets of rows Interactions occur in
+    mem_sets                = 3,    // T sets
+    mem_set_rows            = 4,    // the sets of rows T sets occur in
+    mem_conflicts           = 5,    // location conflicts
+    mem_deltas              = 6,    // detection deltas, while kept in memory
+    mem_maps                = 7,    // the string maps of Singles, Interactions, and T sets
+    mem_row_scores          = 8,    // memoized heuristic_all() scores
+    mem_rows                = 9,    // the rows themselves
+    mem_clones              = 10,   // everything in the copies made by Array::clone()
+    mem_families            = 11
+} mem_family;
+
+void memory_note(mem_family family, int64_t bytes);     // adds to (or, when negative, takes from) a count
+uint64_t memory_live(mem_family family);                // bytes a family holds now
+uint64_t memory_peak(mem_family family);                // most bytes a family has held
+uint64_t memory_live_total();                           // bytes all families hold now
+uint64_t memory_peak_total();                           // most bytes all families have held together
+const char *memory_family_name(mem_family family);      // name to print a family by
+uint64_t heap_bytes(const std::string &str);            // bytes a string holds outside of itself
+
+// while one of these is alive, everything the thread allocates or frees is counted as part of a clone
+class Memory_Clone_Scope
+{
+    public:
+        Memory_Clone_Scope();
+        ~Memory_Clone_Scope();
+
+    private:
+        bool outer;
+};
+
+// std::allocator, except that it counts what it hands out towards a family
+template <typename V, mem_family family>
+class Counting_Allocator
+{
+    public:
+        typedef V value_type;
+        template <typename U> struct rebind { typedef Counting_Allocator<U, family> other; };
+
+        Counting_Allocator() = default;
+        template <typename U> Counting_Allocator(const Counting_Allocator<U, family>&) {}
+
+        V *allocate(size_t n)
+        {
+            V *ptr = std::allocator<V>().allocate(n);
+            memory_note(family, static_cast<int64_t>(n*sizeof(V)));
+            return ptr;
+        }
+
+        void deallocate(V *ptr, size_t n)
+        {
+            memory_note(family, -static_cast<int64_t>(n*sizeof(V)));
+            std::allocator<V>().deallocate(ptr, n);
+        }
+};
+
+template <typename V, typename U, mem_family family>
+bool operator==(const Counting_Allocator<V, family>&, const Counting_Allocator<U, family>&) { return true; }
+
+template <typename V, typename U, mem_family family>
+bool operator!=(const Counting_Allocator<V, family>&, const Counting_Allocator<U, family>&) { return false; }
+
+// std::set and std::map, counted towards a family
+template <typename V, mem_family family>
+using counted_set = std::set<V, std::less<V>, Counting_Allocator<V, family>>;
+
+template <typename K, typename V, mem_family family>
+using counted_map = std::map<K, V, std::less<K>, Counting_Allocator<std::pair<const K, V>, family>>;
+
+#endif // MEMORY
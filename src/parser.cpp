@@ -41,20 +41,156 @@ Parser::Parser(int32_t argc, const std::vector<std::string>& argv) : Parser()
 {
     int32_t itr = 1, num_params = 0;
     p = c_only;
-    bool multichar = false;
+    std::string multichar = "";    // multichar option still waiting for its value, if any
     while (itr < argc) {
         const std::string& arg = argv[itr];    // cast to std::string
-        if (multichar) {
-            if (partial_filename.empty()) partial_filename = arg;
-            else printf("NOTE: --partial specified more than once, ignoring <%s>\n", arg.c_str());
-            multichar = false;
+        if (multichar.compare("--partial") == 0 || multichar.compare("--extend") == 0) {
+            if (partial_filename.empty()) {
+                partial_filename = arg;
+                extend = multichar.compare("--extend") == 0;
+            } else printf("NOTE: --partial or --extend specified more than once, ignoring <%s>\n", arg.c_str());
+            multichar = "";
             itr++;
             continue;
         }
-        if (arg.compare("--partial") == 0) {
-            multichar = true;
+        if (multichar.compare("--effort") == 0) {
+            try {
+                int64_t level = std::stol(arg);
+                effort = static_cast<int16_t>(std::min<int64_t>(std::max<int64_t>(level, 0), 10));
+            } catch ( ... ) {
+                printf("NOTE: --effort expects an int from 0 to 10, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--batch") == 0) {
+            try {
+                uint64_t k = std::stoul(arg);
+                if (k < 1 || k > UINT16_MAX) throw 0;
+                batch = static_cast<uint16_t>(k);
+            } catch ( ... ) {
+                printf("NOTE: --batch expects a positive int, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--progress") == 0) {
+            try {
+                double seconds = std::stod(arg);
+                if (!(seconds >= 0)) throw 0;
+                progress = seconds;
+            } catch ( ... ) {
+                printf("NOTE: --progress expects a number of seconds, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--memory") == 0) {
+            try {
+                uint64_t megabytes = std::stoull(arg);
+                if (megabytes < 1) throw 0;
+                memory_budget = megabytes*1024*1024;
+            } catch ( ... ) {
+                printf("NOTE: --memory expects a positive number of megabytes, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--workers") == 0) {
+            try {
+                uint64_t n = std::stoul(arg);
+                if (n < 1 || n > UINT16_MAX) throw 0;
+                workers = static_cast<uint16_t>(n);
+            } catch ( ... ) {
+                printf("NOTE: --workers expects a positive int, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--shrink") == 0) {
+            try {
+                double seconds = std::stod(arg);
+                if (!(seconds > 0)) throw 0;
+                shrink = seconds;
+            } catch ( ... ) {
+                printf("NOTE: --shrink expects a positive number of seconds, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--exact") == 0) {
+            try {
+                double seconds = std::stod(arg);
+                if (!(seconds > 0)) throw 0;
+                exact = seconds;
+            } catch ( ... ) {
+                printf("NOTE: --exact expects a positive number of seconds, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--stagnation") == 0) {
+            try {
+                if (arg.empty() || arg[0] == '-') throw 0;
+                stagnation = std::stoull(arg);
+            } catch ( ... ) {
+                printf("NOTE: --stagnation expects a number of rows, ignoring <%s>\n", arg.c_str());
+            }
+            multichar = "";
             itr++;
-            continue;   // partial is the only multichar option here
+            continue;
+        }
+        if (multichar.compare("--strategy") == 0) {
+            std::stringstream names(arg);
+            std::string name;
+            while (std::getline(names, name, ',')) if (!name.empty()) strategies.push_back(name);
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (multichar.compare("--trace") == 0) {
+            if (trace_filename.empty()) trace_filename = arg;
+            else printf("NOTE: --trace specified more than once, ignoring <%s>\n", arg.c_str());
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (arg.compare("--partial") == 0 || arg.compare("--extend") == 0 || arg.compare("--effort") == 0 ||
+            arg.compare("--batch") == 0 ||
+            arg.compare("--progress") == 0 || arg.compare("--trace") == 0 || arg.compare("--memory") == 0 ||
+            arg.compare("--workers") == 0 || arg.compare("--shrink") == 0 ||
+            arg.compare("--exact") == 0 || arg.compare("--strategy") == 0 ||
+            arg.compare("--stagnation") == 0) {
+            multichar = arg;
+            itr++;
+            continue;
+        }
+        if (arg.compare("--seed") == 0) {
+            seed = true;
+            itr++;
+            continue;
+        }
+        if (arg.compare("--ipog") == 0) {
+            ipog = true;
+            itr++;
+            continue;
+        }
+        if (arg.compare("--density") == 0) {
+            strategies.push_back("density");
+            itr++;
+            continue;
+        }
+        if (arg.compare("--plan") == 0) {
+            plan = true;
+            itr++;
+            continue;
         }
         if (arg[0] == '-') { // flags
             for (size_t j = 1; j < arg.length(); ++j) {
@@ -124,6 +260,34 @@ uint16_t Parser::get_delta(){
     return delta;
 }
 
+bool Parser::get_seed(){
+    return seed;
+}
+
+bool Parser::get_ipog(){
+    return ipog;
+}
+
+bool Parser::get_extend(){
+    return extend;
+}
+
+double Parser::get_exact(){
+    return exact;
+}
+
+double Parser::get_shrink(){
+    return shrink;
+}
+
+bool Parser::get_plan(){
+    return plan;
+}
+
+uint16_t Parser::get_batch(){
+    return batch;
+}
+
 /* SUB METHOD: process_input - reads from standard in to initialize program data
  * 
  * parameters:
@@ -161,12 +325,13 @@ int32_t Parser::process_input()
 
     // levels
     std::getline(in, cur_line);
+    std::vector<uint16_t> read_levels;
     try {
         std::istringstream iss(cur_line);
         uint16_t level;
         for (uint16_t i = 0; i < num_cols; i++) {
             if (!(iss >> level)) throw 0;   // error when not enough levels given or not int
-            levels.push_back(level);
+            read_levels.push_back(level);
         }
     } catch (...) {
         syntax_error(2, "L_1 L_2 ... L_C", cur_line);
@@ -175,9 +340,7 @@ int32_t Parser::process_input()
     }
 
     in.close();
-    if (bad_t(t, num_cols)) return -1;
-    if (p != c_only && bad_d(d, t, &levels, p)) return -1;
-    if (p == all && bad_delta(d, t, delta, &levels)) return -1;
+    if (process_levels(read_levels) == -1) return -1;
     if (partial_filename.empty()) return 0;
 
     // partial array
@@ -190,13 +353,29 @@ int32_t Parser::process_input()
         printf("\n");
         return -1;
     }
-    uint16_t *row;
     uint64_t i = 0;
+    array = Row_Matrix(num_cols, *std::max_element(levels.begin(), levels.end()));
+    uint16_t width = num_cols;  // values per line; fewer when the rows are being extended with new columns
+    if (extend) {
+        std::getline(partial, cur_line);
+        std::istringstream iss(cur_line);
+        int32_t next_val;
+        for (width = 0; iss >> next_val; width++);
+        if (width < 1 || width > num_cols) {
+            partial.close();
+            printf("\t-- ERROR --\n\tRows in %s have %hu values, but --extend needs from 1 to %hu (the input's "
+                "factors).\n\n", partial_filename.c_str(), width, num_cols);
+            return -1;
+        }
+        extend_cols = width;
+        partial.clear();
+        partial.seekg(0);
+    }
     while (std::getline(partial, cur_line)) {
         i++;
         try {
             std::istringstream iss(cur_line);
-            for (uint16_t j = 0; j < num_cols; j++) {
+            for (uint16_t j = 0; j < width; j++) {
                 int32_t next_val;
                 if (!(iss >> next_val)) throw 0;
                 if (next_val < 0) {
@@ -210,33 +389,56 @@ int32_t Parser::process_input()
             other_error(i, cur_line);
             return -1;
         }
+        std::vector<uint16_t> row(num_cols, 0);    // any new columns are filled in by Array::extend_rows()
         try {
-            row = new uint16_t[num_cols];
             std::istringstream iss(cur_line);
-            for (uint16_t j = 0; j < num_cols; j++) {
+            for (uint16_t j = 0; j < width; j++) {
                 if (!(iss >> row[j])) throw 0;
                 if (row[j] >= levels.at(j)) {   // error when array value out of range
                     partial.close();
                     semantic_error(i, i, j+1, levels.at(j), row[j], 0, false);
-                    delete[] row;
                     return -1;
                 }
             }
         } catch (...) {
             partial.close();
             other_error(i, cur_line);
-            delete[] row;
             return -1;
         }
-        array.push_back(row);
+        array.append(row.data());
         num_rows++;
     }
     partial.close();
     return 0;
 }
 
-std::vector<uint16_t*> getArray() {
-    return array;
+/* SUB METHOD: process_levels - takes the factors' levels directly, instead of from an input file
+ * - used by process_input() once it has read the levels, and by callers that have them already (see glue.cpp)
+ *
+ * parameters:
+ * - given: level of each factor, in column order
+ *
+ * returns:
+ * - code representing success/failure, after checking that t, d, and δ are possible with these levels
+*/
+int32_t Parser::process_levels(const std::vector<uint16_t> &given)
+{
+    levels = given;
+    num_cols = static_cast<uint16_t>(levels.size());
+    if (num_cols < 1) {
+        printf("\t-- ERROR --\n\tThere must be at least one factor.\n\n");
+        return -1;
+    }
+    if (bad_t(t, num_cols)) return -1;
+    if (p != c_only && bad_d(d, t, &levels, p)) return -1;
+    if (p == all && bad_delta(d, t, delta, &levels)) return -1;
+    return 0;
+}
+
+std::vector<std::vector<uint16_t>> Parser::getArray() {
+    std::vector<std::vector<uint16_t>> rows;
+    for (uint64_t r = 0; r < array.size(); r++) rows.push_back(array.row(r));
+    return rows;
 }
 
 // ======================================================================================================= //
@@ -327,13 +529,6 @@ void Parser::other_error(uint64_t lineno, std::string line, bool verbose)
     printf("\n");
 }
 
-/* DECONSTRUCTOR - frees memory
-*/
-Parser::~Parser()
-{
-    for (uint16_t *row : array) delete[] row;
-}
-
 // ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
 
 bool bad_t(uint16_t t, uint16_t num_cols)
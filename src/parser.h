@@ -17,6 +17,7 @@ Last updated 12/22/2022
 #ifndef PARSER
 #define PARSER
 
+#include "rows.h"
 #include <string>
 #include <vector>
 #include <fstream>
@@ -107,16 +108,70 @@ class Parser
         std::vector<uint16_t> levels;
 
         // the array itself, only used when the --partial flag is given
-        std::vector<uint16_t*> array;
+        Row_Matrix array;
+
+        // whether to start from an algebraic seed block, only when the --seed flag is given
+        bool seed = false;
+
+        // whether to build a covering array one column at a time first, only when the --ipog flag is given
+        bool ipog = false;
+
+        // whether the partial array is an existing array to add new columns to, only when --extend is given
+        bool extend = false;
+
+        // with --extend, the number of columns the existing rows have; the rest of the input's factors are new
+        uint16_t extend_cols = 0;
+
+        // whether to only print the sizing plan (see plan.h) and stop, only when the --plan flag is given
+        bool plan = false;
+
+        // effort level 0-10 for adaptive heuristic scheduling, -1 (fixed thresholds) unless --effort is given
+        int16_t effort = -1;
+
+        // rows generation may spend stalled before it is given up (see stagnation.cpp), 200 unless
+        // --stagnation is given; 0 gives up at the first stall
+        uint64_t stagnation = 200;
+
+        // names of the strategies to build rows with, in the order to try them (see strategy.h); empty (the
+        // built-in choice) unless --strategy or --density is given
+        std::vector<std::string> strategies;
+
+        // rows to choose jointly per add_rows() call, 1 (one row at a time) unless --batch is given
+        uint16_t batch = 1;
+
+        // seconds between progress lines, -1 (no progress lines) unless --progress is given
+        double progress = -1;
+
+        // CSV file to trace the score into after every row, only when the --trace flag is given
+        std::string trace_filename;
+
+        // memory budget in bytes, beyond which large state is spilled to disk; 0 (automatic) unless --memory
+        uint64_t memory_budget = 0;
+
+        // processes to score heuristic_all() candidates across, 1 (this process only) unless --workers is given
+        uint16_t workers = 1;
+
+        // seconds to spend removing rows from the finished array, 0 (no shrinking) unless --shrink is given
+        double shrink = 0;
+
+        // seconds to spend searching for an array with the fewest rows, 0 (no search) unless --exact is given
+        double exact = 0;
 
         uint16_t get_d();
         uint16_t get_t();
         uint16_t get_delta();
-        std::vector<uint16_t*> getArray();
+        bool get_seed();
+        bool get_ipog();
+        bool get_extend();
+        double get_exact();
+        double get_shrink();
+        bool get_plan();
+        uint16_t get_batch();
+        std::vector<std::vector<uint16_t>> getArray();
         int32_t process_input();            // call this to process the input file
+        int32_t process_levels(const std::vector<uint16_t> &given); // or this, to skip the file
         Parser();                           // default constructor, probably won't be used
         Parser(int32_t argc, const std::vector<std::string>& argv); // constructor to read arguments and flags
-        ~Parser();                      // deconstructor
 
     private:
         // input filename
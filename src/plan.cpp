@@ -0,0 +1,221 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for the methods declared in plan.h. The counts follow the constructor    |
+| exactly: Interactions are the degree-t elementary symmetric polynomial of the levels, and T sets are all  |
+| size-d combinations of Interactions. Byte estimates are sizeof() each object plus typical libstdc++ node  |
+| and string overheads, so they are close but not exact; location conflicts are left out, since they only |
+| grow as rows are added. The row bound is the larger of two counting arguments: every interaction of the  |
+| t columns with the largest levels must occur (δ times each, for detection), and every T set must occur in |
+| a distinct set of rows, which needs at least log2 of their number of rows.                                |
+|===========================================================================================================|
+*/
+
+#include "parser.h"
+#include "array.h"
+#include "plan.h"
+#include <algorithm>
+#include <math.h>
+#include <unistd.h>
+#include <sys/statvfs.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// typical overheads: a red-black tree node around its payload, and a std::string's heap buffer past SSO
+#define TREE_NODE_BYTES 32
+#define SSO_CAPACITY 15
+
+// rough seconds per unit of work, for the time guesses (the Array's own starting unit_cost)
+#define SECONDS_PER_UNIT 1e-7
+
+// method forward declarations
+static uint64_t sat_add(uint64_t a, uint64_t b);
+static uint64_t sat_mul(uint64_t a, uint64_t b);
+static uint64_t choose(uint64_t n, uint64_t k);
+static uint64_t string_heap_bytes(uint64_t length);
+
+/* SUB METHOD: plan_array - sizes the generation the given Parser describes, without building anything
+ *
+ * parameters:
+ * - in: Parser whose process_input() method has been called
+ *
+ * returns:
+ * - the Plan; see plan.h
+*/
+Plan plan_array(Parser *in)
+{
+    Plan plan;
+    uint16_t t = in->t, d = in->d, delta = in->delta;
+    prop_mode p = in->p;
+    std::vector<uint16_t> levels = in->levels;
+
+    // counts
+    std::vector<uint64_t> e(t + 1, 0);  // e[j] is the number of j-way interactions among the columns so far
+    e[0] = 1;
+    for (uint16_t level : levels) {
+        plan.singles += level;
+        for (uint16_t j = t; j > 0; j--) e[j] = sat_add(e[j], sat_mul(e[j-1], level));
+    }
+    plan.interactions = e[t];
+    uint64_t sets_per_interaction = 0;  // T sets any one Interaction is part of
+    if (p != c_only) {
+        plan.sets = choose(plan.interactions, d);
+        sets_per_interaction = choose(plan.interactions - 1, d - 1);
+    }
+
+    // total problems, summed the same way the constructor sums them
+    plan.total_problems = sat_mul(plan.interactions, t + 1);
+    if (p != c_only)
+        plan.total_problems = sat_add(plan.total_problems,
+            sat_add(sat_mul(sat_mul(plan.sets, plan.sets), static_cast<uint64_t>(d)*t), plan.sets));
+    uint64_t tracked = 0;   // (Interaction, T) pairs that are detection issues
+    if (p == prop_mode::all) {
+        tracked = sat_mul(plan.interactions, plan.sets - sets_per_interaction);
+        plan.total_problems = sat_add(plan.total_problems,
+            sat_add(sat_mul(tracked, static_cast<uint64_t>(t)*delta), plan.interactions));
+    }
+
+    // bytes; map keys are copies of the objects' string representations ("f<col>,<val>" per Single)
+    uint64_t single_string = 6, interaction_string = 6*t, set_string = 6*static_cast<uint64_t>(t)*d;
+    uint64_t string_bytes = sizeof(std::string);
+    plan.single_bytes = sat_mul(plan.singles, sizeof(Single) + sizeof(Single*)*2 + TREE_NODE_BYTES +
+        string_bytes + sizeof(Single*) + 2*string_heap_bytes(single_string));
+    plan.interaction_bytes = sat_mul(plan.interactions, sizeof(Interaction) + sizeof(Single*)*t +
+        sizeof(Interaction*) + TREE_NODE_BYTES + string_bytes + sizeof(Interaction*) +
+        2*string_heap_bytes(interaction_string));
+    if (p != c_only) {
+        plan.interaction_bytes = sat_add(plan.interaction_bytes,   // every Interaction's set of its T sets
+            sat_mul(sat_mul(plan.interactions, sets_per_interaction), TREE_NODE_BYTES + sizeof(T*)));
+        plan.set_bytes = sat_mul(plan.sets, sizeof(T) + sizeof(Single*)*t*d + sizeof(Interaction*)*d +
+            sizeof(T*) + TREE_NODE_BYTES + string_bytes + sizeof(T*) + 2*string_heap_bytes(set_string));
+    }
+    if (p == prop_mode::all) {
+        plan.delta_map_bytes = sat_mul(tracked, DELTA_MAP_NODE_BYTES);
+        plan.delta_file_bytes = sat_mul(sat_mul(plan.interactions, plan.sets), sizeof(uint16_t));
+    }
+    uint64_t structures = sat_add(plan.single_bytes, sat_add(plan.interaction_bytes, plan.set_bytes));
+    plan.in_memory_bytes = sat_add(structures, plan.delta_map_bytes);
+    plan.spilled_bytes = structures;
+
+    // the constructor's own decision (see Array::build_deltas())
+    plan.memory_budget = in->memory_budget;
+    if (plan.memory_budget == 0)
+        plan.memory_budget = static_cast<uint64_t>(sysconf(_SC_PHYS_PAGES))*sysconf(_SC_PAGE_SIZE)/2;
+    plan.will_spill = p == prop_mode::all && plan.delta_map_bytes > plan.memory_budget;
+    struct statvfs fs;
+    if (statvfs(Spill_File::directory().c_str(), &fs) == 0)
+        plan.disk_available = static_cast<uint64_t>(fs.f_bavail)*fs.f_frsize;
+
+    // lower bound on rows
+    std::vector<uint16_t> sorted = levels;
+    std::sort(sorted.begin(), sorted.end(), std::greater<uint16_t>());
+    uint64_t largest_product = 1;
+    for (uint16_t j = 0; j < t && j < sorted.size(); j++) largest_product = sat_mul(largest_product, sorted[j]);
+    plan.row_lower_bound = largest_product;
+    plan.bound_reason = "coverage of the t largest levels' interactions";
+    if (p == prop_mode::all && delta > 1 && sat_mul(largest_product, delta) > plan.row_lower_bound) {
+        plan.row_lower_bound = sat_mul(largest_product, delta);
+        plan.bound_reason = "each of those interactions occurring at least delta times, for detection";
+    }
+    if (p != c_only && plan.sets > 1) {
+        uint64_t distinct = static_cast<uint64_t>(ceil(log2(static_cast<double>(plan.sets))));
+        if (distinct > plan.row_lower_bound) {
+            plan.row_lower_bound = distinct;
+            plan.bound_reason = "every T set occurring in a distinct set of rows, for location";
+        }
+    }
+
+    // time guesses: building touches every object once; each row scores about one candidate per Single,
+    // and each candidate updates the row's interactions and their T sets
+    double objects = static_cast<double>(plan.singles) + static_cast<double>(plan.interactions) +
+        static_cast<double>(plan.sets)*d + static_cast<double>(tracked);
+    plan.build_seconds = objects*SECONDS_PER_UNIT;
+    double row_interactions = static_cast<double>(choose(levels.size(), t));
+    plan.row_seconds = static_cast<double>(plan.row_lower_bound)*static_cast<double>(plan.singles)*
+        row_interactions*(1 + static_cast<double>(sets_per_interaction))*SECONDS_PER_UNIT;
+
+    // is it possible here at all
+    uint64_t resident = plan.will_spill ? plan.spilled_bytes : plan.in_memory_bytes;
+    if (plan.interactions == UINT64_MAX || plan.sets == UINT64_MAX || plan.total_problems == UINT64_MAX) {
+        plan.feasible = false;
+        plan.reason = "too many interactions or T sets to even count";
+    } else if (resident > plan.memory_budget) {
+        plan.feasible = false;
+        plan.reason = "needs about " + std::to_string(resident >> 20) + " MB in memory, over the " +
+            std::to_string(plan.memory_budget >> 20) + " MB budget";
+    } else if (plan.will_spill && plan.disk_available > 0 && plan.delta_file_bytes > plan.disk_available) {
+        plan.feasible = false;
+        plan.reason = "the spilled detection state needs about " + std::to_string(plan.delta_file_bytes >> 20) +
+            " MB of disk, but only " + std::to_string(plan.disk_available >> 20) + " MB is free";
+    }
+    return plan;
+}
+
+/* SUB METHOD: print_plan - prints a plan for the command line's --plan flag
+ *
+ * parameters:
+ * - plan: what plan_array() returned
+ *
+ * returns:
+ * - void, but the plan will have been printed
+*/
+void print_plan(const Plan &plan)
+{
+    printf("\nPlan:\n");
+    printf("\t- Singles: %llu\n", static_cast<unsigned long long>(plan.singles));
+    printf("\t- Interactions: %llu\n", static_cast<unsigned long long>(plan.interactions));
+    printf("\t- T sets: %llu\n", static_cast<unsigned long long>(plan.sets));
+    printf("\t- Total problems: %llu\n", static_cast<unsigned long long>(plan.total_problems));
+    printf("\nEstimated memory (MB):\n");
+    printf("\t- Singles: %.1f\n", plan.single_bytes/1048576.0);
+    printf("\t- Interactions: %.1f\n", plan.interaction_bytes/1048576.0);
+    printf("\t- T sets: %.1f\n", plan.set_bytes/1048576.0);
+    if (plan.delta_file_bytes > 0) {
+        printf("\t- Detection deltas in memory: %.1f\n", plan.delta_map_bytes/1048576.0);
+        printf("\t- Detection deltas spilled to disk: %.1f (on disk)\n", plan.delta_file_bytes/1048576.0);
+    }
+    printf("\t- Total, deltas in memory: %.1f\n", plan.in_memory_bytes/1048576.0);
+    if (plan.delta_file_bytes > 0) printf("\t- Total, deltas spilled: %.1f\n", plan.spilled_bytes/1048576.0);
+    printf("\t- Budget: %.1f (%s)\n", plan.memory_budget/1048576.0,
+        plan.will_spill ? "the deltas would be spilled" : "everything would stay in memory");
+    printf("\nAt least %llu rows are needed (%s).\n", static_cast<unsigned long long>(plan.row_lower_bound),
+        plan.bound_reason.c_str());
+    printf("Rough time: %.3g seconds to build, %.3g seconds or more to add rows.\n", plan.build_seconds,
+        plan.row_seconds);
+    if (plan.feasible) printf("\nThis looks feasible.\n\n");
+    else printf("\nThis does not look feasible: %s.\n\n", plan.reason.c_str());
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+static uint64_t sat_add(uint64_t a, uint64_t b)
+{
+    return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+}
+
+static uint64_t sat_mul(uint64_t a, uint64_t b)
+{
+    if (a == 0 || b == 0) return 0;
+    return a > UINT64_MAX/b ? UINT64_MAX : a*b;
+}
+
+static uint64_t choose(uint64_t n, uint64_t k)
+{
+    if (n == UINT64_MAX) return UINT64_MAX; // n itself saturated
+    if (k > n) return 0;
+    k = std::min(k, n - k);
+    unsigned __int128 result = 1;
+    for (uint64_t i = 1; i <= k; i++) {
+        result = result*(n - k + i)/i;  // exact: each partial product is itself a binomial coefficient
+        if (result > UINT64_MAX) return UINT64_MAX;
+    }
+    return static_cast<uint64_t>(result);
+}
+
+static uint64_t string_heap_bytes(uint64_t length)
+{
+    return length > SSO_CAPACITY ? length + 1 : 0;
+}
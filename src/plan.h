@@ -0,0 +1,68 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains a class for sizing a generation before committing to it. Given a Parser whose      |
+| process_input() method has been called, plan_array() works out exactly how many Singles, Interactions,  |
+| and T sets the Array's constructor would build, estimates the bytes each of the internal structures would |
+| take (with the detection deltas both in memory and spilled to disk; see spill.h), gives a lower bound on  |
+| the rows any array with the requested properties must have, and makes a rough guess at the run time. None |
+| of the Array's structures are allocated, so this is cheap even for inputs the constructor could not hold. |
+| Counts too large for 64 bits saturate at UINT64_MAX, and the plan is then marked as not feasible.        |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef PLAN
+#define PLAN
+
+#include "parser.h"
+#include <stdint.h>
+#include <string>
+
+class Plan
+{
+    public:
+        // exactly what the constructor would build
+        uint64_t singles = 0;
+        uint64_t interactions = 0;
+        uint64_t sets = 0;          // 0 when only coverage is wanted, since the T sets are then skipped
+
+        // the starting score, i.e., the total number of problems the rows have to solve
+        uint64_t total_problems = 0;
+
+        // estimated bytes of each structure
+        uint64_t single_bytes = 0;
+        uint64_t interaction_bytes = 0;
+        uint64_t set_bytes = 0;
+        uint64_t delta_map_bytes = 0;   // detection deltas kept in memory
+        uint64_t delta_file_bytes = 0;  // detection deltas spilled to disk instead (not resident)
+
+        // totals resident in memory with the deltas kept in memory, and with them spilled
+        uint64_t in_memory_bytes = 0;
+        uint64_t spilled_bytes = 0;
+
+        // the budget the totals were checked against, and whether the constructor would spill under it
+        uint64_t memory_budget = 0;
+        bool will_spill = false;
+
+        // free space where spill files go, when it could be found out; 0 otherwise
+        uint64_t disk_available = 0;
+
+        // no array with the requested properties has fewer rows than this
+        uint64_t row_lower_bound = 0;
+        std::string bound_reason;
+
+        // order of magnitude guesses at the seconds to build the structures and to add the rows
+        double build_seconds = 0;
+        double row_seconds = 0;
+
+        // whether the job looks possible on this machine, and if not, why not
+        bool feasible = true;
+        std::string reason;
+};
+
+Plan plan_array(Parser *in);            // sizes a generation without building anything
+void print_plan(const Plan &plan);      // prints a plan in the same style as the Array's stats
+
+#endif // PLAN
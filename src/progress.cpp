@@ -0,0 +1,147 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Progress class, which is declared in        |
+| progress.h. The decay model is a least squares line through log(score) against row number over the last  |
+| HISTORY_ROWS rows; its slope is the fraction of the score each row removes, so the rows left are roughly |
+| log(score) divided by that fraction. Seconds left are the rows left at the recent rows per second.       |
+|===========================================================================================================|
+*/
+
+#include "parser.h"
+#include "array.h"
+#include "progress.h"
+#include <math.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// number of recent rows the rates and the decay fit are taken over
+#define HISTORY_ROWS 16
+
+/* CONSTRUCTOR - initializes the object
+ *
+ * parameters:
+ * - interval_seconds: minimum seconds between callbacks; 0 reports after every row
+ * - callback: called with each report; may be empty
+ * - trace_filename: CSV file to write a line per row into; empty for no trace
+*/
+Progress::Progress(double interval_seconds, progress_callback callback_in, const std::string &trace_filename):
+    interval(interval_seconds), callback(callback_in), start(std::chrono::steady_clock::now())
+{
+    if (trace_filename.empty()) return;
+    trace.open(trace_filename.c_str(), std::ofstream::out);
+    if (!trace.is_open()) {
+        printf("NOTE: unable to open <%s> for the progress trace; no trace will be written\n",
+            trace_filename.c_str());
+        return;
+    }
+    trace << "seconds,rows,score,coverage,location,detection,rows_per_second,reduction_per_second,"
+        << "heuristic,eta_rows,eta_seconds,session_memory_bytes,session_peak_memory_bytes\n";
+}
+
+/* DECONSTRUCTOR - frees memory
+*/
+Progress::~Progress()
+{
+    if (trace.is_open()) trace.close();
+}
+
+/* SUB METHOD: update - records the Array's state after a row, and reports it if the interval has elapsed
+ *
+ * parameters:
+ * - array: the Array being generated
+ * - final: whether generation has stopped; the report is then made regardless of the interval
+ *  --> a score of 0 also counts as final, so a finished array is reported once, by the call for its last row
+ *
+ * returns:
+ * - false if the callback asked for generation to stop, true otherwise
+*/
+bool Progress::update(Array *array, bool final)
+{
+    Progress_Report report;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.rows = array->getNum_Tests();
+    report.score = array->score;
+    array->getScore_Breakdown(&report.c_score, &report.l_score, &report.d_score);
+    report.heuristic = array->getHeuristic();
+    report.session_memory_bytes = memory_live_total();
+    report.session_peak_memory_bytes = memory_peak_total();
+    report.final = final || report.score == 0;
+
+    // rows rolled back after a stall (see stagnation.cpp) make the history meaningless, so the rates restart
+    if (!history_rows.empty() && report.rows < history_rows.back()) {
+        history_seconds.clear();
+        history_rows.clear();
+        history_score.clear();
+    }
+
+    // the final call usually comes right after the last row's call; don't count that row twice
+    bool new_row = history_rows.empty() || history_rows.back() != report.rows;
+    if (new_row) {
+        history_seconds.push_back(report.seconds);
+        history_rows.push_back(report.rows);
+        history_score.push_back(report.score);
+        if (history_rows.size() > HISTORY_ROWS) {
+            history_seconds.pop_front();
+            history_rows.pop_front();
+            history_score.pop_front();
+        }
+    }
+    estimate(&report);
+
+    if (trace.is_open() && new_row)
+        trace << report.seconds << ',' << report.rows << ',' << report.score << ',' << report.c_score << ','
+            << report.l_score << ',' << report.d_score << ',' << report.rows_per_second << ','
+            << report.reduction_per_second << ',' << report.heuristic << ',' << report.eta_rows << ','
+            << report.eta_seconds << ',' << report.session_memory_bytes << ','
+            << report.session_peak_memory_bytes << '\n';
+    if (trace.is_open() && report.final) trace.flush();
+
+    if (!callback || (!report.final && last_report >= 0 && report.seconds - last_report < interval)) return true;
+    if (final_reported) return true;    // the finished array was already reported by its last row
+    last_report = report.seconds;
+    final_reported = report.final;
+    return callback(report);
+}
+
+/* HELPER METHOD: estimate - fills in the rates and the time remaining from the recent history
+ *
+ * parameters:
+ * - report: report whose rows, score, and seconds are already current
+ *
+ * returns:
+ * - void, but after the method finishes, the rates and estimates in the report will be filled in
+*/
+void Progress::estimate(Progress_Report *report)
+{
+    if (report->score == 0) {
+        report->eta_rows = 0;
+        report->eta_seconds = 0;
+    }
+    if (history_rows.size() < 2) return;
+    double elapsed = history_seconds.back() - history_seconds.front();
+    double rows_added = static_cast<double>(history_rows.back() - history_rows.front());
+    double reduction = static_cast<double>(history_score.front()) - static_cast<double>(history_score.back());
+    if (elapsed > 0) {
+        report->rows_per_second = rows_added/elapsed;
+        report->reduction_per_second = reduction/elapsed;
+    }
+    if (report->score == 0) return;
+
+    // least squares slope of log(score) against rows, over the rows where the score was still positive
+    double n = 0, sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+    for (uint64_t i = 0; i < history_rows.size(); i++) {
+        if (history_score[i] == 0) continue;
+        double x = static_cast<double>(history_rows[i]), y = log(static_cast<double>(history_score[i]));
+        n++; sum_x += x; sum_y += y; sum_xx += x*x; sum_xy += x*y;
+    }
+    double denominator = n*sum_xx - sum_x*sum_x;
+    if (n < 2 || denominator <= 0) return;
+    double decay = -(n*sum_xy - sum_x*sum_y)/denominator;   // fraction of the score removed per row
+    if (decay <= 0) return;     // not falling, so no estimate
+    report->eta_rows = log(static_cast<double>(report->score))/decay + 1;
+    if (report->rows_per_second > 0) report->eta_seconds = report->eta_rows/report->rows_per_second;
+}
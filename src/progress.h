@@ -0,0 +1,93 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains a class for reporting progress while rows are being added. The Array calls into a |
+| Progress object after every row (see Array::complete()); the Progress object keeps a short history of the |
+| score, works out rates over that history, and passes a Progress_Report to a callback whenever the chosen |
+| interval has elapsed. The estimate of rows remaining comes from fitting an exponential decay to the score |
+| over the recent rows, which is how greedy construction tends to behave; it is only an estimate, and is   |
+| left negative while the score is not falling. Every row can also be written to a CSV trace file.         |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef PROGRESS
+#define PROGRESS
+
+#include <stdint.h>
+#include <string>
+#include <deque>
+#include <fstream>
+#include <chrono>
+#include <functional>
+
+class Array;    // forward declaration; array.h has no include guard, so it is left to the source files
+
+// what a progress callback is given
+class Progress_Report
+{
+    public:
+        // wall clock time since the Progress object was created
+        double seconds = 0;
+
+        // rows in the array so far
+        uint64_t rows = 0;
+
+        // total score, and the part of it remaining in each category
+        uint64_t score = 0;
+        uint64_t c_score = 0, l_score = 0, d_score = 0;
+
+        // rates over the recent history
+        double rows_per_second = 0;
+        double reduction_per_second = 0;
+
+        // heuristic the Array will use for its next row
+        std::string heuristic;
+
+        // bytes the counted structures of every Array in the process hold now, and the most they have held;
+        // the counts are not kept per Array (see memory.h)
+        uint64_t session_memory_bytes = 0;
+        uint64_t session_peak_memory_bytes = 0;
+
+        // estimated rows and seconds still needed; negative when no estimate is possible yet
+        double eta_rows = -1;
+        double eta_seconds = -1;
+
+        // whether this is the last report, made once the array is finished or generation has stopped
+        bool final = false;
+};
+
+// returns false to ask for generation to stop early
+typedef std::function<bool(const Progress_Report&)> progress_callback;
+
+class Progress
+{
+    public:
+        bool update(Array *array, bool final = false);  // call after each row; returns the callback's answer
+        Progress(double interval_seconds, progress_callback callback, const std::string &trace_filename = "");
+        ~Progress();
+
+    private:
+        // minimum seconds between callbacks (the final report is always made)
+        double interval;
+
+        // where reports go; may be empty when only a trace is wanted
+        progress_callback callback;
+
+        // CSV trace, when a filename was given
+        std::ofstream trace;
+
+        // when this object was created, and when the callback was last called
+        std::chrono::steady_clock::time_point start;
+        double last_report = -1;
+        bool final_reported = false;
+
+        // (seconds, rows, score) for the most recent rows
+        std::deque<double> history_seconds;
+        std::deque<uint64_t> history_rows, history_score;
+
+        void estimate(Progress_Report *report);
+};
+
+#endif // PROGRESS
@@ -0,0 +1,64 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Row_Matrix class, which is declared in      |
+| rows.h. The cells are kept in one of two vectors, chosen by cell width when the matrix is made, so every  |
+| method has a narrow and a wide branch.                                                                    |
+|===========================================================================================================|
+*/
+
+#include "rows.h"
+#include <algorithm>
+
+/* CONSTRUCTOR - initializes the object
+ *
+ * parameters:
+ * - cols: values per row
+ * - max_level: highest level of any column; cells take one byte when it is at most 256
+*/
+Row_Matrix::Row_Matrix(uint16_t cols, uint16_t max_level) : cols(cols), narrow(max_level <= 256) {}
+
+void Row_Matrix::append(const uint16_t *row)
+{
+    if (narrow) cells8.insert(cells8.end(), row, row + cols);
+    else cells16.insert(cells16.end(), row, row + cols);
+    num_rows++;
+}
+
+void Row_Matrix::pop_back()
+{
+    if (num_rows == 0) return;
+    num_rows--;
+    if (narrow) cells8.resize(num_rows*cols);
+    else cells16.resize(num_rows*cols);
+}
+
+void Row_Matrix::clear()
+{
+    num_rows = 0;
+    cells8.clear();
+    cells16.clear();
+}
+
+void Row_Matrix::copy_row(uint64_t row, uint16_t *out) const
+{
+    if (narrow) std::copy(cells8.begin() + row*cols, cells8.begin() + (row + 1)*cols, out);
+    else std::copy(cells16.begin() + row*cols, cells16.begin() + (row + 1)*cols, out);
+}
+
+std::vector<uint16_t> Row_Matrix::row(uint64_t r) const
+{
+    std::vector<uint16_t> values(cols);
+    copy_row(r, values.data());
+    return values;
+}
+
+void Row_Matrix::assign(const Row_Matrix &other)
+{
+    cols = other.cols;
+    num_rows = other.num_rows;
+    narrow = other.narrow;
+    cells8 = other.cells8;
+    cells16 = other.cells16;
+}
@@ -0,0 +1,81 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains a class for storing the rows of an array as one contiguous, growable matrix, in    |
+| place of a separate allocation per row. Cells take one byte each when every level fits in one (at most    |
+| 256 values), and two bytes otherwise; either way, values go in and come out as uint16_t. Indexing the     |
+| matrix gives a Row_View, which reads a row in place; since adding rows may move the storage, a view       |
+| should not be kept across additions. Cells are counted towards the rows family (see memory.h).            |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef ROWS
+#define ROWS
+
+#include "memory.h"
+#include <stdint.h>
+#include <vector>
+
+class Row_Matrix;
+
+// reads one row of a Row_Matrix in place
+class Row_View
+{
+    public:
+        uint16_t operator[](uint16_t col) const;    // value in a column
+        Row_View(const Row_Matrix *matrix, uint64_t row) : matrix(matrix), row(row) {}
+
+    private:
+        const Row_Matrix *matrix;
+        uint64_t row;
+};
+
+class Row_Matrix
+{
+    public:
+        uint64_t size() const { return num_rows; }
+        bool empty() const { return num_rows == 0; }
+        uint16_t width() const { return cols; }
+
+        // value in a cell
+        uint16_t get(uint64_t row, uint16_t col) const
+        {
+            return narrow ? cells8[row*cols + col] : cells16[row*cols + col];
+        }
+
+        Row_View operator[](uint64_t row) const { return Row_View(this, row); }
+
+        void append(const uint16_t *row);           // adds a row of width() values to the end
+        void pop_back();                            // removes the last row
+        void clear();                               // removes every row, keeping the cell width
+        void copy_row(uint64_t row, uint16_t *out) const;   // writes a row's values into out
+        std::vector<uint16_t> row(uint64_t r) const;        // a row's values, as a vector
+        void assign(const Row_Matrix &other);       // copies another's rows
+
+        // writes a column's values into out, one cell per row
+        template <typename Out> void read_column(uint16_t col, Out *out) const
+        {
+            for (uint64_t r = 0; r < num_rows; r++) out[r] = get(r, col);
+        }
+
+        Row_Matrix(uint16_t cols = 0, uint16_t max_level = 0);
+
+    private:
+        // values per row, rows so far, and whether cells take one byte
+        uint16_t cols = 0;
+        uint64_t num_rows = 0;
+        bool narrow = true;
+
+        // the cells, row after row; only the vector matching the cell width is used
+        std::vector<uint8_t, Counting_Allocator<uint8_t, mem_rows>> cells8;
+        std::vector<uint16_t, Counting_Allocator<uint16_t, mem_rows>> cells16;
+};
+
+inline uint16_t Row_View::operator[](uint16_t col) const
+{
+    return matrix->get(row, col);
+}
+
+#endif // ROWS
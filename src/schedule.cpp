@@ -0,0 +1,226 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds the adaptive heuristic scheduler, which is used in place of the fixed thresholds  |
+| in update_heuristic() whenever an effort level is given (--effort). Every row added by add_row() is      |
+| timed, and its score reduction is charged to the heuristic that produced it. A row costs 1 plus lambda   |
+| times its CPU seconds, where lambda comes from the effort level. Efficiency is the fraction of the        |
+| remaining score solved per unit of that cost, which stays comparable as the score decays over a run.     |
+| When the current heuristic's recent efficiency sags, or it has simply been a while, one of the more      |
+| thorough heuristics is probed for a few rows, and kept only if it beats the heuristic it interrupted;    |
+| each losing probe moves the next probe one rung further up the ladder. Heavy heuristics are only probed  |
+| when their predicted per-row cost fits the effort level.                                                 |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include "strategy.h"
+#include <math.h>
+#include <algorithm>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// number of rows a probed heuristic gets before it is judged
+#define PROBE_ROWS 2
+
+// minimum rows on a heuristic before it can be interrupted by a probe
+#define SETTLE_ROWS 3
+
+// a probe is also forced after this many rows, doubling each time a probe loses
+#define INITIAL_PROBE_INTERVAL 8
+
+// the heaviest heuristics are not probed if one row is predicted to cost more than this many rows
+#define PROBE_BUDGET_ROWS 50
+
+// method forward declarations
+static const char *heuristic_name(prop_mode h);
+
+/* SUB METHOD: record_heuristic - charges a finished row to the heuristic that produced it
+ *
+ * parameters:
+ * - h: the heuristic that chose the row
+ * - prev_score: the array's score before the row was added
+ * - cpu_seconds: CPU time spent choosing and adding the row, over all threads
+ * - num_rows: how many rows were added for that time (add_rows() reports a whole batch at once)
+ *
+ * returns:
+ * - void, but after the method finishes, heuristic_stats will include the row
+*/
+void Array::record_heuristic(prop_mode h, uint64_t prev_score, double cpu_seconds, uint64_t num_rows)
+{
+    Heuristic_Stats *stats = &heuristic_stats[h];
+    uint64_t reduction = prev_score > score ? prev_score - score : 0;
+    double gain = prev_score > 0 ? static_cast<double>(reduction)/prev_score : 0;
+    double efficiency = gain/(num_rows + effort_lambda()*cpu_seconds);
+    stats->rows += num_rows;
+    stats->reduction += reduction;
+    stats->cpu_seconds += cpu_seconds;
+    stats->recent = stats->rows == num_rows ? efficiency : 0.7*stats->recent + 0.3*efficiency;
+    if (stats->recent > stats->best) stats->best = stats->recent;
+    if (probe_rows_left > 0) {
+        probe_gain += gain;
+        probe_cost += num_rows + effort_lambda()*cpu_seconds;
+    }
+
+    // calibrate the per-candidate cost model used to decide whether heavy heuristics are affordable
+    if ((h == prop_mode::all || h == d_only) && candidate_rows(h)*total_problems > 0) {
+        unit_cost = cpu_seconds/(candidate_rows(h)*total_problems);
+        if (debug == d_on) printf("==%d== Scheduler: unit cost calibrated to %g\n", getpid(), unit_cost);
+    }
+}
+
+/* HELPER METHOD: heuristic_ladder - the heuristics suiting the current properties, cheapest to most thorough
+ * - the same order update_heuristic() moves through; stagnation.cpp climbs it too
+ *
+ * returns:
+ * - the heuristics, in order
+*/
+std::vector<prop_mode> Array::heuristic_ladder()
+{
+    if (p == c_only) return {c_only, d_only, prop_mode::all};
+    if (p == c_and_l) return {c_only, l_only, d_only, prop_mode::all};
+    if (delta_matrix) return {c_only, l_only, l_and_d};     // spilled state cannot be cloned
+    return {c_only, l_only, l_and_d, d_only, prop_mode::all};
+}
+
+/* HELPER METHOD: schedule_heuristic - adaptive replacement for the thresholds in update_heuristic()
+ *  --> only called when an effort level was given; should only be called after a row is kept
+ *
+ * returns:
+ * - void, but after the method finishes, heuristic_in_use may have changed
+*/
+void Array::schedule_heuristic()
+{
+    just_switched_heuristics = false;
+    std::vector<prop_mode> ladder = heuristic_ladder();
+
+    if (heuristic_in_use == none) { // start as thorough as the effort level can comfortably afford
+        uint16_t rung = ladder.size() - 1;
+        while (rung > 0 && effort_lambda()*candidate_rows(ladder[rung])*total_problems*unit_cost > 1) rung--;
+        heuristic_in_use = ladder[rung];
+        if (o == normal || v == v_on)
+            printf("\t- Scheduler: starting with %s.\n", heuristic_name(heuristic_in_use));
+        just_switched_heuristics = true;
+        rows_on_heuristic = 0;
+        return;
+    }
+    rows_on_heuristic++;
+
+    // a probe is underway; once it has had its rows, either keep it or go back
+    if (probe_rows_left > 0) {
+        if (--probe_rows_left > 0) return;
+        double probe_efficiency = probe_cost > 0 ? probe_gain/probe_cost : 0;
+        double home_efficiency = heuristic_stats[probe_home].recent;
+        if (probe_efficiency > home_efficiency) {
+            if (o == normal || v == v_on)
+                printf("\t- Scheduler: keeping %s (%.5f vs %.5f for %s).\n", heuristic_name(heuristic_in_use),
+                    probe_efficiency, home_efficiency, heuristic_name(probe_home));
+            probe_interval = INITIAL_PROBE_INTERVAL;
+            probe_losses = 0;
+        } else {
+            if (o == normal || v == v_on)
+                printf("\t- Scheduler: returning to %s (%.5f vs %.5f for %s).\n", heuristic_name(probe_home),
+                    home_efficiency, probe_efficiency, heuristic_name(heuristic_in_use));
+            heuristic_in_use = probe_home;
+            just_switched_heuristics = true;
+            probe_interval *= 2;    // back off; the probe will be worth retrying later on
+            probe_losses++;         // and try a more thorough heuristic next time
+        }
+        rows_on_heuristic = 0;
+        return;
+    }
+
+    // otherwise, see whether the next heuristic on the ladder deserves a probe
+    size_t rung = 0;
+    while (rung < ladder.size() && ladder[rung] != heuristic_in_use) rung++;
+    if (rung + 1 >= ladder.size() || rows_on_heuristic < SETTLE_ROWS) return;
+    Heuristic_Stats *stats = &heuristic_stats[heuristic_in_use];
+    bool sagging = stats->recent < 0.5*stats->best;
+    if (!sagging && rows_on_heuristic < probe_interval) return;
+    uint16_t higher = ladder.size() - rung - 1;
+    prop_mode next = ladder[rung + 1 + probe_losses % higher];
+    double predicted = candidate_rows(next)*total_problems*unit_cost;
+    if ((next == prop_mode::all || next == d_only) && effort_lambda()*predicted > PROBE_BUDGET_ROWS) {
+        if (debug == d_on) printf("==%d== Scheduler: %s predicted at %.1fs per row, not probing\n", getpid(),
+            heuristic_name(next), predicted);
+        if (next != ladder[rung + 1]) probe_losses = 0; // start over from the cheapest alternative
+        return;
+    }
+    if (o == normal || v == v_on)
+        printf("\t- Scheduler: %s at %.5f (best %.5f), probing %s for %d rows.\n",
+            heuristic_name(heuristic_in_use), stats->recent, stats->best, heuristic_name(next), PROBE_ROWS);
+    probe_home = heuristic_in_use;
+    probe_rows_left = PROBE_ROWS;
+    probe_gain = 0; probe_cost = 0;
+    heuristic_in_use = next;
+    just_switched_heuristics = true;
+    rows_on_heuristic = 0;
+}
+
+const char *Array::getHeuristic()
+{
+    if (!chain.empty() && last_strategy) return last_strategy->name.c_str();
+    return heuristic_name(heuristic_in_use);
+}
+
+/* HELPER METHOD: effort_lambda - converts the effort level into the CPU seconds to rows exchange rate
+ * - effort 5 makes one CPU second cost as much as one row; each step up makes time cheaper by ~2.5x
+ *
+ * returns:
+ * - how many rows one CPU second is worth
+*/
+double Array::effort_lambda()
+{
+    return pow(10.0, (5.0 - effort)/2.5);
+}
+
+/* HELPER METHOD: candidate_rows - how many candidate rows a heuristic scores per row added
+ *
+ * parameters:
+ * - h: the heuristic in question
+ *
+ * returns:
+ * - number of candidates (1 for the lightweight heuristics, which do not enumerate)
+*/
+double Array::candidate_rows(prop_mode h)
+{
+    if (h != prop_mode::all && h != d_only) return 1;
+    std::vector<uint16_t> levels;
+    double count = 1;
+    for (uint16_t col = 0; col < num_factors; col++) {
+        levels.push_back(factors[col]->level);
+        count *= factors[col]->level;
+    }
+    if (h == d_only) {  // a locked interaction fixes t columns; assume the largest ones, to stay optimistic
+        std::sort(levels.rbegin(), levels.rend());
+        for (uint16_t i = 0; i < t && i < levels.size(); i++) count /= levels[i];
+    }
+    return count;
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+static const char *heuristic_name(prop_mode h)
+{
+    switch (h) {
+        case c_only:
+        case c_and_l:
+        case c_and_d:
+            return "heuristic_c_only";
+        case l_only:
+            return "heuristic_l_only";
+        case l_and_d:
+            return "heuristic_l_and_d";
+        case d_only:
+            return "heuristic_d_only";
+        case prop_mode::all:
+            return "heuristic_all";
+        default:
+            return "random";
+    }
+}
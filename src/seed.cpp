@@ -0,0 +1,304 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds the algebraic seeding stage. When the levels of the factors fit inside a finite    |
+| field GF(q) for some prime power q, classical orthogonal array constructions (Bush for strength t, and    |
+| Rao-Hamming for strength 2) produce a block of rows that covers every t-way interaction at once. Factors  |
+| with fewer than q levels have their values folded down (value mod level), which keeps every interaction |
+| covered. The block is then loaded through the bulk path so that the heuristics in heuristics.cpp only     |
+| need to fix whatever location and detection issues remain. A seed is only used when its row count stays  |
+| close to the counting bound for coverage; otherwise the greedy construction is left to do all the work.   |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <set>
+#include <algorithm>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// largest field the seeding stage is willing to build arithmetic tables for
+#define MAX_SEED_FIELD 256
+
+// a folded seed is only used when it has at most this fraction more rows than the counting bound
+#define SEED_MARGIN 0.25
+
+// tiny helper class for arithmetic in GF(q), where q = p^n; elements are the integers 0 to q-1, read as
+// polynomials over GF(p) whose coefficients are the base-p digits of the integer
+class Field
+{
+    public:
+        // order of the field
+        uint16_t q = 0;
+
+        // characteristic and degree of the field
+        uint16_t p = 0, n = 0;
+
+        uint16_t add(uint16_t a, uint16_t b) const { return add_table[a*q + b]; }
+        uint16_t mul(uint16_t a, uint16_t b) const { return mul_table[a*q + b]; }
+        Field(uint16_t order, uint16_t characteristic, uint16_t degree);
+
+    private:
+        std::vector<uint16_t> add_table;
+        std::vector<uint16_t> mul_table;
+
+        bool build_mul_table(std::vector<uint16_t> *modulus);
+};
+
+// method forward declarations
+static bool prime_power(uint16_t q, uint16_t *p, uint16_t *n);
+static uint64_t int_pow(uint64_t base, uint16_t exp);
+static void build_bush(Field *gf, uint16_t t, uint16_t num_cols, std::vector<uint16_t*> *block);
+static void build_rao_hamming(Field *gf, uint16_t m, uint16_t num_cols, std::vector<uint16_t*> *block);
+
+/* CONSTRUCTOR - initializes the object
+ * - builds full addition and multiplication tables; searches for an irreducible modulus when n > 1
+*/
+Field::Field(uint16_t order, uint16_t characteristic, uint16_t degree) :
+    q(order), p(characteristic), n(degree)
+{
+    add_table.resize(static_cast<uint64_t>(q)*q);
+    for (uint16_t a = 0; a < q; a++)
+        for (uint16_t b = 0; b < q; b++) {  // digit-wise addition mod p
+            uint16_t sum = 0, place = 1, x = a, y = b;
+            for (uint16_t i = 0; i < n; i++) {
+                sum += ((x % p + y % p) % p)*place;
+                x /= p; y /= p; place *= p;
+            }
+            add_table[a*q + b] = sum;
+        }
+
+    // try every monic polynomial of degree n until one yields a field (i.e., it is irreducible)
+    std::vector<uint16_t> modulus(n);
+    for (uint16_t tail = 0; tail < q; tail++) {
+        uint16_t x = tail;
+        for (uint16_t i = 0; i < n; i++) {
+            modulus[i] = x % p;
+            x /= p;
+        }
+        if (build_mul_table(&modulus)) return;
+    }
+}
+
+/* HELPER METHOD: build_mul_table - fills out the multiplication table modulo the given polynomial
+ *
+ * parameters:
+ * - modulus: low order coefficients of a monic degree n polynomial over GF(p)
+ *
+ * returns:
+ * - whether the table describes a field (no zero divisors); the table is left filled in either way
+*/
+bool Field::build_mul_table(std::vector<uint16_t> *modulus)
+{
+    mul_table.assign(static_cast<uint64_t>(q)*q, 0);
+    std::vector<uint16_t> da(n), db(n), prod(2*n);
+    for (uint16_t a = 1; a < q; a++) {
+        for (uint16_t i = 0, x = a; i < n; i++, x /= p) da[i] = x % p;
+        for (uint16_t b = 1; b < q; b++) {
+            for (uint16_t i = 0, x = b; i < n; i++, x /= p) db[i] = x % p;
+            std::fill(prod.begin(), prod.end(), 0);
+            for (uint16_t i = 0; i < n; i++)
+                for (uint16_t j = 0; j < n; j++) prod[i+j] = (prod[i+j] + da[i]*db[j]) % p;
+            for (uint16_t i = 2*n - 1; i >= n; i--) {   // reduce using x^n = -(modulus)
+                if (prod[i] == 0) continue;
+                for (uint16_t j = 0; j < n; j++)
+                    prod[i-n+j] = (prod[i-n+j] + (p - modulus->at(j))*prod[i]) % p;
+                prod[i] = 0;
+            }
+            uint16_t val = 0;
+            for (uint16_t i = n; i > 0; i--) val = val*p + prod[i-1];
+            if (val == 0) return false; // zero divisor, so the modulus was reducible
+            mul_table[a*q + b] = val;
+        }
+    }
+    return true;
+}
+
+/* SUB METHOD: add_seed - seeds an empty array with an algebraic orthogonal array construction
+ * - only does anything when the array has no rows yet and some construction fits the factor levels
+ * - among all fitting constructions, the one with the fewest rows is used
+ * - it is dropped when, once folded, it is more than SEED_MARGIN over the counting bound, since the greedy
+ *   heuristics then tend to need fewer rows on their own
+ *
+ * returns:
+ * - the number of rows added to the array (0 when no seed was applicable)
+*/
+uint64_t Array::add_seed()
+{
+    if (num_tests != 0 || num_factors < t) return 0;
+
+    // the counting bound for coverage is the product of the t largest levels
+    std::vector<uint16_t> levels;
+    for (uint16_t col = 0; col < num_factors; col++) levels.push_back(factors[col]->level);
+    std::sort(levels.rbegin(), levels.rend());
+    uint64_t bound = 1;
+    for (uint16_t i = 0; i < t; i++) bound *= levels[i];
+    uint64_t limit = 2*bound;   // larger constructions are not worth building to see how far they fold
+
+    uint16_t best_q = 0, best_m = 0;    // best_m == 0 means Bush, otherwise Rao-Hamming with q^m rows
+    uint64_t best_rows = UINT64_MAX;
+    for (uint16_t q = std::max<uint16_t>(levels[0], 2); q <= MAX_SEED_FIELD; q++) {
+        uint16_t prime, degree;
+        if (!prime_power(q, &prime, &degree)) continue;
+        if (int_pow(q, t) > limit) break;   // any larger field only gets worse
+        if ((t == 1 || (t <= q && num_factors <= q + 1)) && int_pow(q, t) < best_rows) {
+            best_rows = int_pow(q, t);
+            best_q = q; best_m = 0;
+        }
+        if (t != 2) continue;
+        uint16_t m = 2;
+        while ((int_pow(q, m) - 1)/(q - 1) < num_factors) m++;
+        if (int_pow(q, m) <= limit && int_pow(q, m) < best_rows) {
+            best_rows = int_pow(q, m);
+            best_q = q; best_m = m;
+        }
+    }
+    if (best_q == 0) {
+        if (debug == d_on) printf("==%d== No algebraic seed applies to these levels\n", getpid());
+        return 0;
+    }
+
+    uint16_t prime, degree;
+    if (!prime_power(best_q, &prime, &degree)) return 0;
+    Field gf(best_q, prime, degree);
+    std::vector<uint16_t*> block;
+    if (best_m == 0) build_bush(&gf, t, num_factors, &block);
+    else build_rao_hamming(&gf, best_m, num_factors, &block);
+
+    // fold field elements down onto each factor's levels; for coverage only, duplicates are useless
+    std::set<std::string> seen;
+    std::vector<uint16_t*> folded;
+    for (uint16_t *row : block) {
+        std::string row_str = "";
+        for (uint16_t col = 0; col < num_factors; col++) {
+            row[col] %= factors[col]->level;
+            row_str += std::to_string(row[col]) + ' ';
+        }
+        if (p == c_only && !seen.insert(row_str).second) delete[] row;
+        else folded.push_back(row);
+    }
+    if (folded.size() > bound + static_cast<uint64_t>(SEED_MARGIN*bound)) {
+        if (debug == d_on) printf("==%d== A seed of %llu rows is too far over the bound of %llu\n", getpid(),
+            static_cast<unsigned long long>(folded.size()), static_cast<unsigned long long>(bound));
+        for (uint16_t *row : folded) delete[] row;
+        return 0;
+    }
+
+    if (o != silent)
+        printf("Seeding array with %llu rows from a %s construction over GF(%hu).\n",
+            static_cast<unsigned long long>(folded.size()), best_m == 0 ? "Bush" : "Rao-Hamming", best_q);
+    load_rows(&folded);
+    for (uint16_t *row : folded) delete[] row;
+    return folded.size();
+}
+
+/* SUB METHOD: load_rows - adds a whole block of rows, deferring the per-row bookkeeping to the end
+ * - the rows are copied, so the caller keeps ownership of the block
+ *
+ * parameters:
+ * - block: vector of rows to append to the array, in order
+ *
+ * returns:
+ * - void, but after the method finishes, the array will have all rows of the block appended to its end
+*/
+void Array::load_rows(std::vector<uint16_t*> *block)
+{
+    if (block->empty()) return;
+    for (uint16_t *row : *block) {
+        uint16_t *new_row = new uint16_t[num_factors];
+        for (uint16_t col = 0; col < num_factors; col++) new_row[col] = row[col];
+        update_array(new_row, true, true);
+    }
+    update_dont_cares();
+    update_heuristic();
+    just_switched_heuristics = true;    // keeps heuristic_all from breaking if called right away
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+static bool prime_power(uint16_t q, uint16_t *p, uint16_t *n)
+{
+    if (q < 2) return false;
+    uint16_t f = 2;
+    while (q % f != 0) f++; // smallest prime factor
+    uint16_t deg = 0;
+    while (q % f == 0) {
+        q /= f;
+        deg++;
+    }
+    if (q != 1) return false;
+    *p = f; *n = deg;
+    return true;
+}
+
+static uint64_t int_pow(uint64_t base, uint16_t exp)
+{
+    uint64_t ret = 1;
+    for (uint16_t i = 0; i < exp; i++) ret *= base;
+    return ret;
+}
+
+// Bush: one row per polynomial of degree < t, one column per field element (evaluation) plus one more
+// column holding the leading coefficient; this is an OA(q^t; t, q+1, q) whenever t <= q
+static void build_bush(Field *gf, uint16_t t, uint16_t num_cols, std::vector<uint16_t*> *block)
+{
+    uint64_t num_rows = int_pow(gf->q, t);
+    std::vector<uint16_t> coeffs(t);
+    for (uint64_t r = 0; r < num_rows; r++) {
+        uint64_t x = r;
+        for (uint16_t i = 0; i < t; i++) {
+            coeffs[i] = x % gf->q;
+            x /= gf->q;
+        }
+        uint16_t *row = new uint16_t[num_cols];
+        for (uint16_t col = 0; col < num_cols; col++) {
+            if (col == gf->q) { // only reached when num_cols == q + 1
+                row[col] = coeffs[t-1];
+                continue;
+            }
+            uint16_t val = 0;   // Horner's rule evaluation at the field element numbered col
+            for (uint16_t i = t; i > 0; i--) val = gf->add(gf->mul(val, col % gf->q), coeffs[i-1]);
+            row[col] = val;
+        }
+        block->push_back(row);
+    }
+}
+
+// Rao-Hamming: one row per vector v in GF(q)^m, one column per projective point c (first nonzero coordinate
+// equal to 1), with the dot product v.c as the entry; this is an OA(q^m; 2, (q^m-1)/(q-1), q)
+static void build_rao_hamming(Field *gf, uint16_t m, uint16_t num_cols, std::vector<uint16_t*> *block)
+{
+    std::vector<std::vector<uint16_t>> points;
+    uint64_t num_vectors = int_pow(gf->q, m);
+    for (uint64_t v = 1; v < num_vectors && points.size() < num_cols; v++) {
+        std::vector<uint16_t> point(m);
+        uint64_t x = v;
+        for (uint16_t i = 0; i < m; i++) {
+            point[i] = x % gf->q;
+            x /= gf->q;
+        }
+        uint16_t lead = m - 1;
+        while (point[lead] == 0) lead--;
+        if (point[lead] == 1) points.push_back(point);
+    }
+    std::vector<uint16_t> vec(m);
+    for (uint64_t r = 0; r < num_vectors; r++) {
+        uint64_t x = r;
+        for (uint16_t i = 0; i < m; i++) {
+            vec[i] = x % gf->q;
+            x /= gf->q;
+        }
+        uint16_t *row = new uint16_t[num_cols];
+        for (uint16_t col = 0; col < num_cols; col++) {
+            uint16_t val = 0;
+            for (uint16_t i = 0; i < m; i++) val = gf->add(val, gf->mul(vec[i], points[col][i]));
+            row[col] = val;
+        }
+        block->push_back(row);
+    }
+}
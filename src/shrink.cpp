@@ -0,0 +1,475 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h,  |
+| and for the Shrink_State class declared in shrink.h. Specifically, it holds post-optimization: once the   |
+| array is finished, shrink() takes a row out and runs a tabu search over the remaining rows until every    |
+| requested property holds again, repeating for as long as that keeps working and time remains. This is the |
+| idea behind the exactFix() and smartSort() passes of the CSMatrix tool mentioned in README.md, applied to |
+| location and detection as well as coverage. Each step picks one requirement that does not hold (an        |
+| uncovered Interaction, a T set that cannot be located, or a separation short of δ), and considers writing |
+| one of the Interactions involved into each row in turn; the move that leaves the fewest requirements      |
+| unmet wins, except that moves putting back a cell value changed recently are tabu for a few steps, which |
+| keeps the search from cycling. Only the Array's rows are replaced at the end, after which the rest of its |
+| state is settled from them in one pass (see settle_rows() in upgrade.cpp).                               |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include "bitmap.h"
+#include "shrink.h"
+#include <algorithm>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// steps without a new best before a removal attempt is given up on
+#define SHRINK_STALE_STEPS 400
+
+// most rows a step considers writing its Interaction into; larger arrays get a random sample of rows
+#define SHRINK_ROWS_PER_STEP 48
+
+// a changed cell cannot go back to its old value for this many steps, plus up to as many again at random
+#define SHRINK_TENURE 7
+
+// ================================v=v=v== Shrink_State methods ==v=v=v================================ //
+
+int64_t Shrink_State::violations()
+{
+    return uncovered + unlocated + undetected;
+}
+
+int64_t Shrink_State::unlocated_in(uint64_t signature)
+{
+    auto found = signature_count.find(signature);
+    if (found == signature_count.end()) return 0;
+    // a T set is located once it occurs and no other T set occurs in exactly the same rows
+    return (signature == empty_signature || found->second > 1) ? found->second : 0;
+}
+
+uint64_t *Shrink_State::interaction_bits(uint64_t index)
+{
+    return &i_bits[index*words];
+}
+
+uint64_t *Shrink_State::set_bits(uint64_t index)
+{
+    return &t_bits[index*words];
+}
+
+bool Shrink_State::out_of_time()
+{
+    return std::chrono::steady_clock::now() > deadline;
+}
+
+/* DECONSTRUCTOR - frees memory
+*/
+Shrink_State::~Shrink_State()
+{
+    for (uint16_t *row : rows) delete[] row;
+}
+
+// ================================^=^=^== Shrink_State methods ==^=^=^================================ //
+
+/* SUB METHOD: shrink - removes rows from a finished array for as long as all its properties can be kept
+ * - does nothing unless the score is 0; the array still has every property afterwards
+ *
+ * parameters:
+ * - seconds: wall clock time to spend
+ *
+ * returns:
+ * - the number of rows removed
+*/
+uint64_t Array::shrink(double seconds)
+{
+    if (score != 0 || num_tests < 2 || !(seconds > 0)) return 0;
+    stop_workers();     // their replicas would be left holding the old rows
+    std::chrono::duration<double> budget(seconds);
+    auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+    uint64_t start_rows = num_tests;
+    std::vector<uint16_t*> current;     // the smallest set of rows known to work so far
+    for (uint64_t r = 0; r < rows.size(); r++) {
+        uint16_t *copy = new uint16_t[num_factors];
+        rows.copy_row(r, copy);
+        current.push_back(copy);
+    }
+
+    bool removed = true;
+    while (removed && current.size() > 1 && std::chrono::steady_clock::now() < deadline && !cancelled()) {
+        removed = false;
+        // try the rows that do the least on their own first: those covering the fewest Interactions no
+        // other row covers
+        std::vector<std::pair<uint64_t, uint64_t>> order;   // (Interactions only it covers, row)
+        {
+            Shrink_State whole;     // only its bitmaps are used; the rows stay in current
+            whole.words = std::max<uint64_t>(bitmap_words(current.size()), 1);
+            whole.i_bits.assign(interactions.size()*whole.words, 0);
+            for (uint64_t r = 0; r < current.size(); r++) {
+                std::set<Interaction*> found;
+                find_row_interactions(current[r], &found);
+                for (Interaction *i : found) whole.interaction_bits(i->index)[r/64] |= 1ULL << (r % 64);
+            }
+            std::vector<uint64_t> alone(current.size(), 0);
+            for (Interaction *i : interactions) {
+                uint64_t *bits = whole.interaction_bits(i->index), count = 0, last = 0;
+                for (uint64_t w = 0; w < whole.words; w++) {
+                    count += __builtin_popcountll(bits[w]);
+                    if (bits[w]) last = w*64 + 63 - __builtin_clzll(bits[w]);
+                }
+                if (count == 1) alone[last]++;
+            }
+            for (uint64_t r = 0; r < current.size(); r++) order.push_back({alone[r], r});
+            std::sort(order.begin(), order.end());
+        }
+
+        for (auto &candidate : order) {
+            if (std::chrono::steady_clock::now() >= deadline || cancelled()) break;
+            Shrink_State state;
+            state.deadline = deadline;
+            for (uint64_t r = 0; r < current.size(); r++) {
+                if (r == candidate.second) continue;
+                uint16_t *copy = new uint16_t[num_factors];
+                for (uint16_t col = 0; col < num_factors; col++) copy[col] = current[r][col];
+                state.rows.push_back(copy);
+            }
+            shrink_build(&state);
+            if (!shrink_search(&state)) continue;
+            for (uint16_t *row : current) delete[] row;
+            current = state.rows;
+            state.rows.clear();     // now owned by current
+            removed = true;
+            if (o == normal) printf("Removed a row; %llu remain.\n",
+                static_cast<unsigned long long>(current.size()));
+            break;
+        }
+    }
+
+    uint64_t removed_rows = start_rows - current.size();
+    if (removed_rows == 0) {
+        for (uint16_t *row : current) delete[] row;
+        if (o != silent) printf("Could not remove any rows.\n");
+        return 0;
+    }
+
+    // install the new rows, then settle everything else from them
+    rows.clear();
+    for (uint16_t *row : current) rows.append(row);
+    num_tests = rows.size();
+    for (Single *s : singles) s->rows.clear();
+    for (Interaction *i : interactions) i->rows.clear();
+    for (uint64_t r = 0; r < num_tests; r++) {
+        std::set<Interaction*> row_interactions;
+        find_row_interactions(current[r], &row_interactions);
+        for (Interaction *i : row_interactions) {
+            i->rows.insert(r + 1);  // rows are 1-based
+            for (Single *s : i->singles) s->rows.insert(r + 1);
+        }
+    }
+    for (uint16_t *row : current) delete[] row;
+    settle_rows();
+    if (o != silent)
+        printf("Shrank the array from %llu to %llu rows.\n", static_cast<unsigned long long>(start_rows),
+            static_cast<unsigned long long>(num_tests));
+    return removed_rows;
+}
+
+/* HELPER METHOD: shrink_build - sets up a Shrink_State's bitmaps and counts from its rows
+ *
+ * parameters:
+ * - state: state whose rows are already in place
+ *
+ * returns:
+ * - void, but after the method finishes, everything else in the state will describe its rows
+*/
+void Array::shrink_build(Shrink_State *state)
+{
+    uint64_t words = std::max<uint64_t>(bitmap_words(state->rows.size()), 1);
+    state->words = words;
+    state->i_bits.assign(interactions.size()*words, 0);
+    state->i_marked.assign(interactions.size(), false);
+    for (uint64_t r = 0; r < state->rows.size(); r++) {
+        std::set<Interaction*> found;
+        find_row_interactions(state->rows[r], &found);
+        for (Interaction *i : found) state->interaction_bits(i->index)[r/64] |= 1ULL << (r % 64);
+    }
+    std::vector<uint64_t> empty(words, 0);
+    state->empty_signature = bitmap_signature(empty.data(), words);
+    state->uncovered = 0;
+    for (Interaction *i : interactions) {
+        uint64_t *bits = state->interaction_bits(i->index);
+        bool occurs = false;
+        for (uint64_t w = 0; w < words && !occurs; w++) occurs = bits[w] != 0;
+        if (!occurs) state->uncovered++;
+    }
+    if (p == c_only) return;
+
+    state->t_bits.assign(sets.size()*words, 0);
+    state->t_marked.assign(sets.size(), false);
+    state->t_rows.clear();
+    state->t_signature.clear();
+    state->signature_count.clear();
+    for (T *t_set : sets) {
+        uint64_t *bits = state->set_bits(t_set->index);
+        for (Interaction *i : t_set->interactions) or_into(bits, state->interaction_bits(i->index), words);
+        state->t_rows.push_back(bits);
+        state->t_signature.push_back(bitmap_signature(bits, words));
+        state->signature_count[state->t_signature.back()]++;
+    }
+    state->unlocated = 0;
+    for (auto &kv : state->signature_count) state->unlocated += state->unlocated_in(kv.first);
+    if (p != prop_mode::all) return;
+
+    state->undetected = 0;
+    std::vector<uint64_t> separations(sets.size());
+    for (Interaction *i : interactions) {
+        andnot_popcount_batch(state->interaction_bits(i->index), state->t_rows.data(), sets.size(), words,
+            separations.data());
+        for (uint64_t idx = 0; idx < sets.size(); idx++)
+            if (separations[idx] < delta && i->sets.find(sets[idx]) == i->sets.end())
+                state->undetected += delta - separations[idx];
+    }
+}
+
+/* HELPER METHOD: shrink_shortfall - how far the given Interactions and T sets fall short of δ separation
+ * - counts every (Interaction, T set) pair where the Interaction is marked or the T set is, once
+ *
+ * parameters:
+ * - state: working state, with the Interactions and T sets of interest marked
+ * - marked_interactions: the marked Interactions
+ * - marked_sets: the marked T sets
+ *
+ * returns:
+ * - the sum of δ minus the separation over those pairs whose separation is under δ
+*/
+int64_t Array::shrink_shortfall(Shrink_State *state, std::vector<Interaction*> *marked_interactions,
+    std::vector<T*> *marked_sets)
+{
+    int64_t shortfall = 0;
+    std::vector<uint64_t> separations(sets.size());
+    for (Interaction *i : *marked_interactions) {
+        andnot_popcount_batch(state->interaction_bits(i->index), state->t_rows.data(), sets.size(),
+            state->words, separations.data());
+        for (uint64_t idx = 0; idx < sets.size(); idx++)
+            if (separations[idx] < delta && i->sets.find(sets[idx]) == i->sets.end())
+                shortfall += delta - separations[idx];
+    }
+    for (T *t_set : *marked_sets) {
+        uint64_t *t_bits = state->set_bits(t_set->index);
+        for (Interaction *i : interactions) {
+            if (state->i_marked[i->index]) continue;    // already counted above
+            uint64_t separation = andnot_popcount(state->interaction_bits(i->index), t_bits, state->words);
+            if (separation < delta && i->sets.find(t_set) == i->sets.end()) shortfall += delta - separation;
+        }
+    }
+    return shortfall;
+}
+
+/* HELPER METHOD: shrink_change - changes one cell of a Shrink_State's rows, keeping the state up to date
+ * - only the Interactions of the row that involve the column, and the T sets they are part of, can change
+ *
+ * parameters:
+ * - state: working state
+ * - r: index of the row in state->rows
+ * - col: column of the cell
+ * - value: new value of the cell
+ *
+ * returns:
+ * - the change in state->violations(); changing the cell back undoes the change exactly
+*/
+int64_t Array::shrink_change(Shrink_State *state, uint64_t r, uint16_t col, uint16_t value)
+{
+    uint16_t *row = state->rows[r];
+    if (row[col] == value) return 0;
+    std::vector<Interaction*> lost, gained;
+    involving_column(row, col, &lost);
+    row[col] = value;
+    involving_column(row, col, &gained);
+    uint64_t word = r/64, bit = 1ULL << (r % 64), words = state->words;
+    auto is_empty = [&](uint64_t *bits) {
+        for (uint64_t w = 0; w < words; w++) if (bits[w]) return false;
+        return true;
+    };
+
+    std::vector<Interaction*> touched(lost);
+    touched.insert(touched.end(), gained.begin(), gained.end());
+    std::vector<T*> touched_sets;
+    for (Interaction *i : touched) state->i_marked[i->index] = true;
+    if (p != c_only)
+        for (Interaction *i : touched)
+            for (T *t_set : i->sets)
+                if (!state->t_marked[t_set->index]) {
+                    state->t_marked[t_set->index] = true;
+                    touched_sets.push_back(t_set);
+                }
+
+    // what does not hold among the touched things, before
+    int64_t uncovered_before = 0, shortfall_before = 0;
+    for (Interaction *i : touched) uncovered_before += is_empty(state->interaction_bits(i->index));
+    if (p == prop_mode::all) shortfall_before = shrink_shortfall(state, &touched, &touched_sets);
+
+    // the change itself
+    for (Interaction *i : lost) state->interaction_bits(i->index)[word] &= ~bit;
+    for (Interaction *i : gained) state->interaction_bits(i->index)[word] |= bit;
+    std::vector<uint64_t> signatures;   // every signature whose group may have changed, old and new
+    for (T *t_set : touched_sets) {
+        uint64_t *bits = state->set_bits(t_set->index);
+        bits[word] &= ~bit;
+        for (Interaction *i : t_set->interactions)
+            bits[word] |= state->interaction_bits(i->index)[word] & bit;
+        signatures.push_back(state->t_signature[t_set->index]);
+        signatures.push_back(bitmap_signature(bits, words));
+    }
+    std::sort(signatures.begin(), signatures.end());
+    signatures.erase(std::unique(signatures.begin(), signatures.end()), signatures.end());
+    int64_t unlocated_before = 0, unlocated_after = 0;
+    for (uint64_t signature : signatures) unlocated_before += state->unlocated_in(signature);
+    for (T *t_set : touched_sets) {
+        uint64_t &old_signature = state->t_signature[t_set->index];
+        if (--state->signature_count[old_signature] == 0) state->signature_count.erase(old_signature);
+        old_signature = bitmap_signature(state->set_bits(t_set->index), words);
+        state->signature_count[old_signature]++;
+    }
+    for (uint64_t signature : signatures) unlocated_after += state->unlocated_in(signature);
+
+    // and after
+    int64_t uncovered_after = 0, shortfall_after = 0;
+    for (Interaction *i : touched) uncovered_after += is_empty(state->interaction_bits(i->index));
+    if (p == prop_mode::all) shortfall_after = shrink_shortfall(state, &touched, &touched_sets);
+
+    for (Interaction *i : touched) state->i_marked[i->index] = false;
+    for (T *t_set : touched_sets) state->t_marked[t_set->index] = false;
+    state->uncovered += uncovered_after - uncovered_before;
+    state->unlocated += unlocated_after - unlocated_before;
+    state->undetected += shortfall_after - shortfall_before;
+    return (uncovered_after - uncovered_before) + (unlocated_after - unlocated_before) +
+        (shortfall_after - shortfall_before);
+}
+
+/* HELPER METHOD: shrink_target - picks a requirement that does not hold, at random
+ *
+ * parameters:
+ * - state: working state with at least one violation
+ * - targets: initially empty vector to hold the Interactions that could be written into a row to help
+ *
+ * returns:
+ * - void, but after the method finishes, targets will hold at least one Interaction
+*/
+void Array::shrink_target(Shrink_State *state, std::vector<Interaction*> *targets)
+{
+    uint64_t start = rand();
+    if (state->uncovered > 0) {    // an Interaction that occurs nowhere
+        for (uint64_t n = 0; n < interactions.size(); n++) {
+            Interaction *i = interactions[(start + n) % interactions.size()];
+            uint64_t *bits = state->interaction_bits(i->index);
+            bool occurs = false;
+            for (uint64_t w = 0; w < state->words && !occurs; w++) occurs = bits[w] != 0;
+            if (occurs) continue;
+            targets->push_back(i);
+            return;
+        }
+    }
+    if (state->unlocated > 0) {    // a T set that has not occurred, or occurs in the same rows as another
+        for (uint64_t n = 0; n < sets.size(); n++) {
+            T *t_set = sets[(start + n) % sets.size()];
+            if (state->unlocated_in(state->t_signature[t_set->index]) == 0) continue;
+            for (Interaction *i : t_set->interactions) targets->push_back(i);
+            return;
+        }
+    }
+    std::vector<uint64_t> separations(sets.size());     // an Interaction not separated enough from a T set
+    for (uint64_t n = 0; n < interactions.size(); n++) {
+        Interaction *i = interactions[(start + n) % interactions.size()];
+        andnot_popcount_batch(state->interaction_bits(i->index), state->t_rows.data(), sets.size(),
+            state->words, separations.data());
+        for (uint64_t idx = 0; idx < sets.size(); idx++)
+            if (separations[idx] < delta && i->sets.find(sets[idx]) == i->sets.end()) {
+                targets->push_back(i);
+                return;
+            }
+    }
+}
+
+/* HELPER METHOD: shrink_search - tabu search over cell changes until every requirement holds
+ *
+ * parameters:
+ * - state: working state, built by shrink_build()
+ *
+ * returns:
+ * - whether every requirement holds; false if the search went stale or ran out of time first
+*/
+bool Array::shrink_search(Shrink_State *state)
+{
+    std::unordered_map<uint64_t, uint64_t> tabu_until;  // (row, column, value) -> first step it is allowed
+    auto key = [&](uint64_t r, uint16_t col, uint16_t value) {
+        return (r*num_factors + col)*static_cast<uint64_t>(UINT16_MAX + 1) + value;
+    };
+    int64_t best = state->violations();
+    uint64_t stale = 0;
+    for (uint64_t step = 0; state->violations() > 0; step++) {
+        if (stale >= SHRINK_STALE_STEPS || state->out_of_time() || cancelled()) return false;
+        std::vector<Interaction*> targets;
+        shrink_target(state, &targets);
+
+        // the rows to consider writing a target into
+        std::vector<uint64_t> candidate_rows;
+        for (uint64_t r = 0; r < state->rows.size(); r++) candidate_rows.push_back(r);
+        if (candidate_rows.size() > SHRINK_ROWS_PER_STEP) {
+            for (uint64_t n = 0; n < SHRINK_ROWS_PER_STEP; n++)
+                std::swap(candidate_rows[n], candidate_rows[n + rand() % (candidate_rows.size() - n)]);
+            candidate_rows.resize(SHRINK_ROWS_PER_STEP);
+        }
+
+        // score every move by applying it and undoing it
+        int64_t best_change = INT64_MAX;
+        uint64_t ties = 0, chosen_row = 0;
+        Interaction *chosen = nullptr;
+        for (Interaction *i : targets)
+            for (uint64_t r : candidate_rows) {
+                uint16_t *row = state->rows[r];
+                std::vector<std::pair<uint16_t, uint16_t>> undo;    // (column, old value)
+                bool tabu = false;
+                for (Single *s : i->singles) {
+                    if (row[s->factor] == s->value) continue;
+                    auto found = tabu_until.find(key(r, s->factor, s->value));
+                    if (found != tabu_until.end() && found->second > step) tabu = true;
+                    undo.push_back({s->factor, row[s->factor]});
+                }
+                if (undo.empty()) continue;     // already in this row
+                int64_t change = 0;
+                for (Single *s : i->singles) change += shrink_change(state, r, s->factor, s->value);
+                for (auto it = undo.rbegin(); it != undo.rend(); it++)
+                    shrink_change(state, r, it->first, it->second);
+                if (tabu && state->violations() + change >= best) continue;    // tabu, and no new best
+                if (change < best_change) {
+                    best_change = change;
+                    ties = 0;
+                }
+                if (change == best_change && rand() % ++ties == 0) {
+                    chosen = i;
+                    chosen_row = r;
+                }
+            }
+        if (!chosen) {  // every move was tabu; let the list age
+            stale++;
+            continue;
+        }
+
+        // make the move, and forbid changing its cells back for a while
+        for (Single *s : chosen->singles) {
+            uint16_t old_value = state->rows[chosen_row][s->factor];
+            if (old_value == s->value) continue;
+            shrink_change(state, chosen_row, s->factor, s->value);
+            tabu_until[key(chosen_row, s->factor, old_value)] =
+                step + 1 + SHRINK_TENURE + rand() % SHRINK_TENURE;
+        }
+        if (state->violations() < best) {
+            best = state->violations();
+            stale = 0;
+        } else stale++;
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains a class holding the working state of Array::shrink(), which tries to remove rows   |
+| from a finished array. With a row taken out, some requirements no longer hold; a tabu search then changes |
+| cells of the remaining rows until they all hold again. It needs the result of each cell change quickly,   |
+| and the Array's own bookkeeping can only ever add rows, so this keeps a separate, simpler picture of the   |
+| rows: a bitmap per Interaction and per T set (as verify.cpp uses), plus running counts of everything that |
+| does not yet hold. A cell change only touches the Interactions in its row that involve its column, and   |
+| the T sets they are part of, so only those are looked at again (see Array::shrink_change()).              |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef SHRINK
+#define SHRINK
+
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+
+class Shrink_State
+{
+    public:
+        // the rows being repaired; owned by this object until handed back to the Array
+        std::vector<uint16_t*> rows;
+
+        // 64-bit words per bitmap
+        uint64_t words = 1;
+
+        // row bitmaps of every Interaction and T set, by index, each words long and laid out contiguously
+        std::vector<uint64_t> i_bits, t_bits;
+
+        // pointers to each T set's bitmap, for the batched kernels
+        std::vector<uint64_t*> t_rows;
+
+        // signature of each T set's bitmap, and how many T sets have each signature
+        std::vector<uint64_t> t_signature;
+        std::unordered_map<uint64_t, uint64_t> signature_count;
+
+        // signature of a bitmap with no rows in it; T sets with it have not occurred, so cannot be located
+        uint64_t empty_signature = 0;
+
+        // what does not hold yet: Interactions not covered, T sets not located, and the sum over every
+        // (Interaction, T set) pair of how far their separation falls short of δ
+        int64_t uncovered = 0, unlocated = 0, undetected = 0;
+
+        // scratch marks, by index, of the Interactions and T sets a cell change touches
+        std::vector<bool> i_marked, t_marked;
+
+        // when to give up
+        std::chrono::steady_clock::time_point deadline;
+
+        int64_t violations();                   // everything above that does not hold yet
+        int64_t unlocated_in(uint64_t signature); // T sets with this signature that cannot be located
+        uint64_t *interaction_bits(uint64_t index);
+        uint64_t *set_bits(uint64_t index);
+        bool out_of_time();
+        ~Shrink_State();                        // frees the rows still held
+};
+
+#endif // SHRINK
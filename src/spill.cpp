@@ -0,0 +1,160 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Spill_File class, which is declared in     |
+| spill.h, and for the methods of the Array class that decide whether to spill the detection deltas and    |
+| work with them once spilled. Spilled deltas form one dense row of sets.size() separations per           |
+| Interaction, in the order of the sets vector. A separation saturates at δ + 1, since nothing ever cares |
+| how far past δ it gets, which leaves UINT16_MAX free to mark the T sets an Interaction is part of. Every |
+| update is a sequential sweep over one Interaction's row; once the Interaction is detectable its row is  |
+| never read again, so it is marked cold, and only still-unresolved rows stay in memory.                  |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <vector>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+/* CONSTRUCTOR - initializes the object
+ * - creates a sparse file of the given size, so untouched pages read as zero and take no disk space
+ *
+ * parameters:
+ * - bytes_in: size of the region to map
+*/
+Spill_File::Spill_File(uint64_t bytes_in)
+{
+    std::string path = directory() + "/array-generator-spill-XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    fd = mkstemp(name.data());
+    if (fd < 0) return;
+    unlink(name.data());    // the open descriptor keeps the file alive until it is closed
+    if (ftruncate(fd, static_cast<off_t>(bytes_in)) != 0) return;
+    void *mapped = mmap(nullptr, bytes_in, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) return;
+    region = mapped;
+    bytes = bytes_in;
+    ok = true;
+}
+
+/* DECONSTRUCTOR - frees memory
+*/
+Spill_File::~Spill_File()
+{
+    if (region) munmap(region, bytes);
+    if (fd >= 0) close(fd);
+}
+
+void *Spill_File::data()
+{
+    return region;
+}
+
+uint64_t Spill_File::size()
+{
+    return bytes;
+}
+
+/* SUB METHOD: mark_cold - tells the operating system a region of the file is done being used
+ * - only whole pages inside the region are affected; the contents stay valid either way
+ *
+ * parameters:
+ * - start: first byte of the region
+ * - length: length of the region in bytes
+ *
+ * returns:
+ * - void, but after the method finishes, the pages may be reclaimed ahead of others
+*/
+void Spill_File::mark_cold(void *start, uint64_t length)
+{
+#ifdef MADV_COLD
+    uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t first = (reinterpret_cast<uint64_t>(start) + page - 1)/page*page;
+    uint64_t last = (reinterpret_cast<uint64_t>(start) + length)/page*page;
+    if (last > first) madvise(reinterpret_cast<void*>(first), last - first, MADV_COLD);
+#else
+    (void)start; (void)length;
+#endif
+}
+
+std::string Spill_File::directory()
+{
+    const char *tmpdir = getenv("TMPDIR");
+    return tmpdir && tmpdir[0] ? tmpdir : "/tmp";
+}
+
+/* HELPER METHOD: spill_deltas - creates the file the detection deltas are kept in
+ *
+ * returns:
+ * - whether the file could be created; if not, the deltas stay in memory and may not fit
+*/
+bool Array::spill_deltas()
+{
+    if (delta > DELTA_NOT_TRACKED - 2) return false;    // separations saturate at δ + 1, below the marker
+    uint64_t bytes = interactions.size()*sets.size()*sizeof(uint16_t);
+    delta_file = new Spill_File(bytes);
+    if (!delta_file->ok) {
+        printf("NOTE: could not create a %llu MB spill file in <%s>; keeping detection state in memory\n",
+            static_cast<unsigned long long>(bytes >> 20), Spill_File::directory().c_str());
+        delete delta_file;
+        delta_file = nullptr;
+        return false;
+    }
+    delta_matrix = static_cast<uint16_t*>(delta_file->data());
+    if (o != silent)
+        printf("Detection state is over the %llu MB memory budget; keeping it in a %llu MB file in <%s>.\n",
+            static_cast<unsigned long long>(memory_budget >> 20), static_cast<unsigned long long>((bytes >> 20) + 1),
+            Spill_File::directory().c_str());
+    return true;
+}
+
+uint16_t *Array::spilled_deltas(Interaction *i)
+{
+    return delta_matrix + i->index*sets.size();
+}
+
+uint64_t Array::conflict_count(T *t_set)
+{
+    return t_set->conflicts_with_all ? sets.size() - 1 : t_set->location_conflicts.size();
+}
+
+/* HELPER METHOD: update_spilled_deltas - the detection part of update_scores(), for spilled deltas
+ * - separations to T sets in the row stay the same; all others grow by one, saturating at δ + 1
+ *
+ * parameters:
+ * - i: Interaction that occurs in the row being added; must not already be detectable
+ * - row_set_indices: indices of the T sets that occur in the row, sorted
+ *
+ * returns:
+ * - void, but after the method finishes, the Interaction's separations and the scores will be updated, and
+ *   i->is_detectable will be false if any separation is still short of δ
+*/
+void Array::update_spilled_deltas(Interaction *i, std::vector<uint64_t> *row_set_indices)
+{
+    uint16_t *separations = spilled_deltas(i);
+    uint64_t next = 0;  // walks the sorted row set indices alongside the sweep
+    for (uint64_t idx = 0; idx < sets.size(); idx++) {
+        bool in_row = next < row_set_indices->size() && row_set_indices->at(next) == idx;
+        if (in_row) next++;
+        uint16_t &separation = separations[idx];
+        if (separation == DELTA_NOT_TRACKED) continue;  // the Interaction is part of this T set
+        if (!in_row && separation <= delta) separation++;
+        if (separation < delta) i->is_detectable = false;   // separation still not high enough
+        if (!in_row && separation <= delta)     // detection issue heading towards solved
+            for (Single *s: i->singles) {
+                factors[s->factor]->d_issues--;
+                s->d_issues--;
+                score--;
+            }
+    }
+    if (i->is_detectable) delta_file->mark_cold(separations, sets.size()*sizeof(uint16_t));
+}
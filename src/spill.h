@@ -0,0 +1,49 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains a class for keeping a large block of state in a memory-mapped file on local disk   |
+| instead of in RAM. The Array uses it for the detection separations (one per Interaction and T set it is   |
+| not part of) when keeping them in ordinary maps would not fit in the memory budget. The file is created   |
+| in $TMPDIR (or /tmp) and unlinked right away, so it disappears with the process no matter how that ends;  |
+| the operating system pages it in and out as it is used. Regions that will not be needed again can be     |
+| marked cold, so they are the first to be written back and dropped when memory gets tight.               |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef SPILL
+#define SPILL
+
+#include <stdint.h>
+#include <string>
+
+// marks the T sets an Interaction is part of, which are not detection issues for it
+#define DELTA_NOT_TRACKED UINT16_MAX
+
+// approximate bytes per entry in an Interaction's deltas map (red-black tree node plus allocator overhead)
+#define DELTA_MAP_NODE_BYTES 64
+
+class Spill_File
+{
+    public:
+        // whether the file was created and mapped successfully
+        bool ok = false;
+
+        void *data();                               // start of the mapped region
+        uint64_t size();                            // size of the mapped region in bytes
+        void mark_cold(void *start, uint64_t bytes);    // hints that a region will not be touched again
+        static std::string directory();             // where spill files are created
+        Spill_File(uint64_t bytes);                 // constructor that creates and maps a zeroed file
+        ~Spill_File();                              // deconstructor
+
+    private:
+        // file descriptor of the (already unlinked) file
+        int fd = -1;
+
+        // the mapping itself
+        void *region = nullptr;
+        uint64_t bytes = 0;
+};
+
+#endif // SPILL
@@ -0,0 +1,196 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds the generation loop, complete(), and what the loop does when the score stalls. A   |
+| stall used to end the run as soon as STALL_STEPS + 1 steps in a row left the score unchanged, and the     |
+| array was reported impossible, even though the heuristics being stuck is the far more common cause. Now a |
+| stall is handled instead, up to a budget of stalled rows (--stagnation). The rows of the stall solved     |
+| nothing (the score only counts issues, and no issue ever comes back while rows are added), so they are    |
+| always rolled back first, which costs nothing. Then the stalls take turns between three ways out: moving |
+| one rung up the same ladder of heuristics the scheduler climbs, adding random rows built around the       |
+| oldest problems still unsolved, and rolling back ROLLBACK_ROWS more rows to retry them with a new seed.   |
+| Any rows rolled back that had solved something count against the budget too. Rolling back keeps the rows  |
+| of the Singles and Interactions up to the new last row, uncovers the Interactions left without rows, and  |
+| settles everything else from the rows in one pass (see settle_rows() in upgrade.cpp).                    |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <algorithm>
+#include <time.h>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// steps in a row that leave the score unchanged, past which the run is considered stalled
+#define STALL_STEPS 10
+
+// rows added around the oldest unsolved problems when a stall is handled that way
+#define INJECT_ROWS 4
+
+// rows that had solved something, rolled back to retry them when a stall is handled that way
+#define ROLLBACK_ROWS 20
+
+/* SUB METHOD: complete - adds rows until the array has all requested properties, or cannot make progress
+ * - this is the loop main() has always run; it lives here so background jobs and the R driver share it
+ * - stops early, between rows, when the cancel token is set
+ * - stalls are handled by recover() (see the top of this file) until stagnation_budget rows are spent on them
+ *
+ * parameters:
+ * - batch: number of rows to choose jointly at each step (see add_rows()); 1 means one row at a time
+ * - after_row: called after each step, once the step's stats have been printed; may be nullptr
+ *
+ * returns:
+ * - whether the array should be considered finished (running out of memory counts, as it always has);
+ *   never when cancelled, so a cancelled run cannot be reported as a finished array
+*/
+bool Array::complete(uint16_t batch, std::function<void()> after_row)
+{
+    uint64_t prev_score;            // for comparing to current score to see if nothing is changing
+    uint8_t no_change_counter = 0;  // need this to stop an infinite loop if the array cannot be completed
+    uint64_t given_rows = num_tests;    // rows from before the loop, which are never rolled back
+    uint64_t progress_rows = num_tests; // rows as of the last step that changed the score
+    uint64_t stalled_rows = 0;      // rows spent on stalls so far, counted against the budget
+    uint16_t stalls = 0;
+    while (score > 0 && !cancelled()) {
+        prev_score = score;         // needed for catching impossible scenarios
+        if (batch > 1) add_rows(batch); // add another batch of rows
+        else add_row();             // add another row
+        if (out_of_memory) break;
+        if (score == prev_score) no_change_counter++;
+        else {
+            no_change_counter = 0;
+            progress_rows = num_tests;
+        }
+        if (no_change_counter > STALL_STEPS) {
+            stalled_rows += num_tests - progress_rows;
+            if (stalled_rows > stagnation_budget + STALL_STEPS) break;  // the budget is spent; give up
+            stalled_rows += recover(stalls++, num_tests - progress_rows, progress_rows - given_rows);
+            no_change_counter = 0;
+            progress_rows = num_tests;
+        }
+        print_stats();              // report current state of array
+        if (after_row) after_row();
+    }
+    if (cancelled()) return false;
+    return no_change_counter == 0 || out_of_memory;
+}
+
+/* HELPER METHOD: recover - handles a stall, so that generation can carry on
+ *
+ * parameters:
+ * - stall: number of stalls handled before this one, which decides the way out
+ * - stalled: rows at the end of the array that left the score unchanged
+ * - spare: rows before those that may also be rolled back
+ *
+ * returns:
+ * - rows rolled back beyond the stalled ones, which the caller counts against the budget
+*/
+uint64_t Array::recover(uint16_t stall, uint64_t stalled, uint64_t spare)
+{
+    uint64_t extra = stall % 3 == 2 ? std::min<uint64_t>(ROLLBACK_ROWS, spare) : 0;
+    roll_back(stalled + extra);
+    if (extra > 0) {
+        srand(static_cast<unsigned int>(time(nullptr)) + stall);    // retry those rows differently
+        if (o != silent)
+            printf("NOTE: the score stalled; rolled back %llu rows to retry them with a new seed\n",
+                static_cast<unsigned long long>(stalled + extra));
+        return extra;
+    }
+    if (stall % 3 == 0 && escalate_heuristic()) {
+        if (o != silent) printf("NOTE: the score stalled; rolled back %llu rows and moved to a more thorough "
+            "heuristic\n", static_cast<unsigned long long>(stalled));
+        return 0;
+    }
+    uint16_t injected = inject_rows();
+    if (o != silent) printf("NOTE: the score stalled; rolled back %llu rows and added %hu around the oldest "
+        "unsolved problems\n", static_cast<unsigned long long>(stalled), injected);
+    return 0;
+}
+
+/* HELPER METHOD: escalate_heuristic - moves heuristic_in_use one rung up the scheduler's ladder
+ * - the scheduler (--effort) and a chain of strategies choose rows their own way, so they are left alone
+ *
+ * returns:
+ * - whether heuristic_in_use changed
+*/
+bool Array::escalate_heuristic()
+{
+    if (effort >= 0 || !chain.empty()) return false;
+    std::vector<prop_mode> ladder = heuristic_ladder();
+    size_t rung = 0;
+    while (rung < ladder.size() && ladder[rung] != heuristic_in_use) rung++;
+    if (rung + 1 >= ladder.size()) return false;
+    heuristic_in_use = ladder[rung + 1];
+    just_switched_heuristics = true;
+    return true;
+}
+
+/* HELPER METHOD: inject_rows - adds random rows, each built around one of the oldest unsolved problems
+ * - the oldest problems are the first uncovered Interactions, then the first T sets that cannot be located,
+ *   then the first Interactions that cannot be detected, in the order they were built
+ * - a T set is put in its row through one of its Interactions, chosen at random
+ *
+ * returns:
+ * - number of rows added, at most INJECT_ROWS
+*/
+uint16_t Array::inject_rows()
+{
+    std::vector<Interaction*> targets;
+    for (Interaction *i : interactions) {
+        if (targets.size() == INJECT_ROWS) break;
+        if (!i->is_covered) targets.push_back(i);
+    }
+    if (p != c_only) for (T *t_set : sets) {
+        if (targets.size() == INJECT_ROWS) break;
+        if (!t_set->is_locatable)
+            targets.push_back(t_set->interactions[static_cast<uint64_t>(rand()) % t_set->interactions.size()]);
+    }
+    if (p == prop_mode::all) for (Interaction *i : interactions) {
+        if (targets.size() == INJECT_ROWS) break;
+        if (!i->is_detectable) targets.push_back(i);
+    }
+    for (Interaction *target : targets) {
+        uint16_t *new_row = initialize_row_R();
+        for (Single *s : target->singles) new_row[s->factor] = s->value;
+        if (debug == d_on) printf("==%d== Injecting a row around %s\n", getpid(), target->to_string().c_str());
+        update_array(new_row);
+    }
+    return targets.size();
+}
+
+/* HELPER METHOD: roll_back - removes rows from the end of the array
+ *
+ * parameters:
+ * - k: number of rows to remove; should be at most num_tests
+ *
+ * returns:
+ * - void, but after the method finishes, all state will be as if the removed rows had never been added,
+ *   except that heuristic_in_use is kept
+*/
+void Array::roll_back(uint64_t k)
+{
+    if (k == 0) return;
+    stop_workers();     // their replicas have the removed rows; they are restarted when next needed
+    for (uint64_t r = 0; r < k; r++) rows.pop_back();
+    num_tests -= k;
+    for (Single *s : singles) s->rows.erase(s->rows.upper_bound(num_tests), s->rows.end());   // 1-based
+    for (Interaction *i : interactions) {
+        i->rows.erase(i->rows.upper_bound(num_tests), i->rows.end());
+        if (!i->is_covered || !i->rows.empty()) continue;
+        i->is_covered = false;  // its only rows were removed
+        for (Single *s : i->singles) {
+            factors[s->factor]->c_issues++;
+            s->c_issues++;
+        }
+        coverage_problems++;
+        is_covering = false;
+    }
+    prop_mode kept = heuristic_in_use;
+    settle_rows();
+    heuristic_in_use = kept;
+}
@@ -0,0 +1,239 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h,  |
+| and for the Strategy class declared in strategy.h. Specifically, it holds the strategy registry: the      |
+| built-in strategies, how the strategy for each new row is chosen, and the accounting done for every row.  |
+| Without a chain of strategies, each row comes from the built-in strategy matching heuristic_in_use, which |
+| update_heuristic() (or the scheduler in schedule.cpp) keeps choosing as before. With a chain, each row    |
+| comes from the first strategy in it whose last row solved something; a strategy passed over this way     |
+| gets its turn back on the following row, and when every strategy in the chain is stalled, the row comes  |
+| from the built-in choice instead.                                                                        |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include "strategy.h"
+#include <memory>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// method forward declarations
+static const char *builtin_name(prop_mode h);
+
+/* CONSTRUCTOR - initializes the object
+*/
+Strategy::Strategy(const std::string &name, std::function<uint16_t*()> initialize,
+    std::function<bool(uint16_t*)> refine) : name(name), initialize(initialize), refine(refine) {}
+
+/* SUB METHOD: register_strategy - adds a strategy to the Array, or replaces the one with the same name
+ *
+ * parameters:
+ * - name: name to select it by
+ * - initialize: makes a new row, allocated with new[]
+ * - refine: improves the new row in place, returning false if it could not run
+ *
+ * returns:
+ * - void, but after the method finishes, the strategy can be selected with set_strategies()
+*/
+void Array::register_strategy(const std::string &name, std::function<uint16_t*()> initialize,
+    std::function<bool(uint16_t*)> refine)
+{
+    Strategy *existing = find_strategy(name);
+    if (existing) {
+        existing->initialize = initialize;
+        existing->refine = refine;
+        return;
+    }
+    strategies.push_back(new Strategy(name, initialize, refine));
+}
+
+/* SUB METHOD: set_strategies - chooses the chain of strategies rows come from (see the top of this file)
+ * - an empty list goes back to the built-in choice for every row
+ * - strategies needing structures this run does not have are left out (see strategy_unfit())
+ *
+ * parameters:
+ * - names: names of registered strategies, in the order they should be tried
+ *
+ * returns:
+ * - false if some name was not registered or was left out; the others are still used
+*/
+bool Array::set_strategies(std::vector<std::string> names)
+{
+    bool known = true;
+    chain.clear();
+    for (std::string &name : names) {
+        Strategy *strategy = find_strategy(name);
+        if (!strategy) {
+            printf("NOTE: no strategy is called <%s>, ignoring it\n", name.c_str());
+            known = false;
+            continue;
+        }
+        const char *unfit = strategy_unfit(strategy);
+        if (unfit) {
+            printf("NOTE: strategy <%s> cannot run because %s, ignoring it\n", name.c_str(), unfit);
+            known = false;
+            continue;
+        }
+        strategy->stalled = false;
+        chain.push_back(strategy);
+    }
+    return known;
+}
+
+const std::vector<Strategy*> *Array::getStrategies()
+{
+    return &strategies;
+}
+
+/* UTILITY METHOD: print_strategies - outputs how every strategy that added rows has done
+ *
+ * returns:
+ * - void, but after the method finishes, one line per strategy will have been printed
+*/
+void Array::print_strategies()
+{
+    printf("\nStrategies used:\n");
+    for (Strategy *strategy : strategies) {
+        if (strategy->rows == 0) continue;
+        printf("\t- %s: %llu rows, score reduced by %llu, %.3f CPU seconds.\n", strategy->name.c_str(),
+            static_cast<unsigned long long>(strategy->rows),
+            static_cast<unsigned long long>(strategy->reduction), strategy->cpu_seconds);
+    }
+}
+
+/* HELPER METHOD: register_builtin_strategies - registers the heuristics in heuristics.cpp and density.cpp
+ * - the heuristics that lock an Interaction or T set while initializing pass it on to their refine step
+ *
+ * returns:
+ * - void, but after the method finishes, every built-in strategy will be registered
+*/
+void Array::register_builtin_strategies()
+{
+    auto locked = std::make_shared<Interaction*>(nullptr);
+    auto locked_set = std::make_shared<T*>(nullptr);
+    register_strategy("random",
+        [this]() { shuffle_permutation(); return initialize_row_R(); },
+        [](uint16_t*) { return true; });
+    register_strategy("c_only",
+        [this]() { shuffle_permutation(); return initialize_row_S(); },
+        [this](uint16_t *row) { heuristic_c_only(row); return true; });
+    register_strategy("l_only",
+        [this, locked_set, locked]() {
+            shuffle_permutation();
+            return initialize_row_T(locked_set.get(), locked.get());
+        },
+        [this, locked_set, locked](uint16_t *row) {
+            heuristic_l_only(row, *locked_set, *locked);
+            return true;
+        });
+    register_strategy("l_and_d",
+        [this, locked]() { shuffle_permutation(); return initialize_row_I(locked.get()); },
+        [this, locked](uint16_t *row) { heuristic_l_and_d(row, *locked); return true; });
+    register_strategy("d_only",
+        [this, locked]() { shuffle_permutation(); return initialize_row_R(locked.get()); },
+        [this, locked](uint16_t *row) { return heuristic_all(row, *locked); });
+    register_strategy("all",
+        [this]() { shuffle_permutation(); return initialize_row_R(); },
+        [this](uint16_t *row) { return heuristic_all(row); });
+    register_strategy("density",
+        [this]() { return new uint16_t[num_factors]; },
+        [this](uint16_t *row) { heuristic_density(row); return true; });
+}
+
+Strategy *Array::find_strategy(const std::string &name)
+{
+    for (Strategy *strategy : strategies) if (strategy->name == name) return strategy;
+    return nullptr;
+}
+
+/* HELPER METHOD: choose_strategy - picks the strategy the next row comes from (see the top of this file)
+ * - strategies in the chain that cannot run now are passed over, since upgrade() and spilling change what
+ *   structures there are after set_strategies() checked them
+ *
+ * parameters:
+ * - builtin: where to record whether the built-in choice was made, which the scheduler then accounts for
+ *
+ * returns:
+ * - the strategy to use
+*/
+Strategy *Array::choose_strategy(bool *builtin)
+{
+    *builtin = false;
+    for (Strategy *strategy : chain) {
+        if (strategy_unfit(strategy)) continue;
+        if (!strategy->stalled) return strategy;
+        strategy->stalled = false;  // passed over once; it gets the row after this one
+    }
+    *builtin = true;
+    return find_strategy(builtin_name(heuristic_in_use));
+}
+
+/* HELPER METHOD: strategy_unfit - tells whether a built-in strategy needs structures this run does not have
+ * - the locking heuristics need T sets, which coverage alone does not build
+ * - d_only and all are kept for detection, and, as in heuristic_ladder(), away from spilled deltas, since
+ *   heuristic_all() scores rows on clones of the Array and spilled deltas cannot be cloned
+ *
+ * parameters:
+ * - strategy: the strategy to check
+ *
+ * returns:
+ * - why the strategy cannot run, or nullptr if it can
+*/
+const char *Array::strategy_unfit(Strategy *strategy)
+{
+    bool locking = strategy->name == "l_only" || strategy->name == "l_and_d";
+    bool thorough = strategy->name == "d_only" || strategy->name == "all";
+    if ((locking || thorough) && p == c_only) return "coverage alone builds no T sets";
+    if (thorough && p != prop_mode::all) return "it needs detection";
+    if (thorough && delta_matrix) return "the deltas are spilled to disk";
+    return nullptr;
+}
+
+/* HELPER METHOD: charge_strategy - records rows added by a strategy
+ *
+ * parameters:
+ * - strategy: the strategy that chose the rows
+ * - prev_score: the array's score before the rows were added
+ * - cpu_seconds: CPU time spent choosing and adding the rows, over all threads
+ * - num_rows: how many rows were added for that time
+ *
+ * returns:
+ * - void, but after the method finishes, the strategy's counts will include the rows
+*/
+void Array::charge_strategy(Strategy *strategy, uint64_t prev_score, double cpu_seconds, uint64_t num_rows)
+{
+    uint64_t reduction = prev_score > score ? prev_score - score : 0;
+    strategy->rows += num_rows;
+    strategy->reduction += reduction;
+    strategy->cpu_seconds += cpu_seconds;
+    strategy->stalled = reduction == 0;
+    last_strategy = strategy;
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+// name of the built-in strategy for each value heuristic_in_use can take
+static const char *builtin_name(prop_mode h)
+{
+    switch (h) {
+        case c_only:
+        case c_and_l:
+        case c_and_d:
+            return "c_only";
+        case l_only:
+            return "l_only";
+        case l_and_d:
+            return "l_and_d";
+        case d_only:
+            return "d_only";
+        case prop_mode::all:
+            return "all";
+        default:
+            return "random";
+    }
+}
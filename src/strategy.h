@@ -0,0 +1,46 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This header contains the Strategy class, the unit Array::add_row() builds rows with. A strategy has a   |
+| name to be selected by, a way to initialize a new row, and a way to refine it; the Array charges every    |
+| row it adds to the strategy that chose it, so strategies can be compared by rows, score reduction, and    |
+| CPU time without any of them keeping count. The heuristics in heuristics.cpp and the density engine are |
+| registered as strategies when an Array is made (see strategy.cpp); others can be added with              |
+| Array::register_strategy(), and chosen (or chained) with Array::set_strategies() or --strategy.          |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef STRATEGY
+#define STRATEGY
+
+#include <stdint.h>
+#include <string>
+#include <functional>
+
+class Strategy
+{
+    public:
+        // name it is selected by
+        std::string name;
+
+        // makes a new row, allocated with new[]; the Array takes ownership of it
+        std::function<uint16_t*()> initialize;
+
+        // improves the new row in place; false means the strategy could not run (it ran out of memory)
+        std::function<bool(uint16_t*)> refine;
+
+        // rows added by this strategy, the score reduction they achieved, and the CPU seconds they took
+        uint64_t rows = 0;
+        uint64_t reduction = 0;
+        double cpu_seconds = 0;
+
+        // whether its last row solved nothing; a chain then hands the next row to the strategy after it
+        bool stalled = false;
+
+        Strategy(const std::string &name, std::function<uint16_t*()> initialize,
+            std::function<bool(uint16_t*)> refine);
+};
+
+#endif // STRATEGY
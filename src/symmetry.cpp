@@ -0,0 +1,152 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds the symmetry pruning used by heuristic_all(). Every Interaction and T set exists  |
+| for every combination of columns and values, and a row's score depends only on the rows already in the   |
+| array, so any relabeling of values or reordering of same-level columns that maps the current rows onto   |
+| themselves also maps each candidate row onto one with the same score. Two kinds are found:               |
+| - values a and b of a column are interchangeable when the rows with a there and the rows with b there    |
+|   are otherwise identical (as multisets); this relation is transitive, so it splits values into classes  |
+| - two columns with the same level are interchangeable when swapping them maps the rows onto themselves, |
+|   which is likewise transitive, so it splits columns into classes                                        |
+| Candidates are then enumerated only in canonical form (every value the smallest of its class, and values |
+| non-decreasing across each column class), and the chosen row is mapped to a random member of its orbit, |
+| so ties are still broken among all the rows that would have tied. Columns of a locked Interaction are    |
+| left out, so the candidates all still contain it. Early on, before the rows have told the values and     |
+| columns apart, and for inputs with many same-level factors, this removes most of the candidates.         |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <algorithm>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// no previous column in the same class
+#define NO_COLUMN UINT16_MAX
+
+/* SUB METHOD: find_symmetries - works out the value and column classes for the current rows
+ *
+ * parameters:
+ * - locked: pointer to Interaction whose columns must not be altered; nullptr for none
+ *
+ * returns:
+ * - void, but after the method finishes, value_class, prev_in_class, and has_symmetry will be current
+*/
+void Array::find_symmetries(Interaction *locked)
+{
+    std::vector<bool> is_locked(num_factors, false);
+    if (locked) for (Single *s : locked->singles) is_locked[s->factor] = true;
+    value_class.assign(num_factors, std::vector<uint16_t>());
+    prev_in_class.assign(num_factors, NO_COLUMN);
+    has_symmetry = false;
+    uint64_t value_merges = 0, column_merges = 0;
+
+    // value classes: values whose rows agree everywhere else share a class
+    for (uint16_t col = 0; col < num_factors; col++) {
+        uint16_t level = factors[col]->level;
+        value_class[col].resize(level);
+        for (uint16_t value = 0; value < level; value++) value_class[col][value] = value;
+        if (is_locked[col]) continue;
+        std::vector<std::vector<std::vector<uint16_t>>> rest(level);   // per value, the rows without col
+        for (uint64_t r = 0; r < rows.size(); r++) {
+            std::vector<uint16_t> others = rows.row(r);
+            others.erase(others.begin() + col);
+            rest[rows.get(r, col)].push_back(others);
+        }
+        for (auto &r : rest) std::sort(r.begin(), r.end());
+        for (uint16_t value = 1; value < level; value++)
+            for (uint16_t smaller = 0; smaller < value; smaller++)
+                if (value_class[col][smaller] == smaller && rest[smaller] == rest[value]) {
+                    value_class[col][value] = smaller;
+                    value_merges++;
+                    break;
+                }
+    }
+
+    // column classes: same-level columns that can be swapped without changing the rows
+    std::vector<std::vector<uint16_t>> sorted_rows;
+    for (uint64_t r = 0; r < rows.size(); r++) sorted_rows.push_back(rows.row(r));
+    std::sort(sorted_rows.begin(), sorted_rows.end());
+    std::vector<uint16_t> class_of(num_factors);    // smallest column in each column's class
+    std::vector<uint16_t> last_in_class(num_factors);
+    for (uint16_t col = 0; col < num_factors; col++) {
+        class_of[col] = col;
+        last_in_class[col] = col;
+        if (is_locked[col]) continue;
+        for (uint16_t other = 0; other < col; other++) {
+            if (class_of[other] != other || is_locked[other] || factors[other]->level != factors[col]->level)
+                continue;
+            std::vector<std::vector<uint16_t>> swapped = sorted_rows;
+            for (auto &r : swapped) std::swap(r[col], r[other]);
+            std::sort(swapped.begin(), swapped.end());
+            if (swapped != sorted_rows) continue;
+            class_of[col] = other;
+            prev_in_class[col] = last_in_class[other];
+            last_in_class[other] = col;
+            column_merges++;
+            break;
+        }
+    }
+
+    has_symmetry = value_merges > 0 || column_merges > 0;
+    if (debug == d_on && has_symmetry)
+        printf("==%d== Symmetry: %llu values and %llu columns are interchangeable with others\n", getpid(),
+            static_cast<unsigned long long>(value_merges), static_cast<unsigned long long>(column_merges));
+}
+
+/* HELPER METHOD: is_canonical - checks whether a candidate row is the representative of its orbit
+ *
+ * parameters:
+ * - row: integer array representing a fully formed candidate row
+ *
+ * returns:
+ * - whether heuristic_all_helper() should score the row
+*/
+bool Array::is_canonical(uint16_t *row)
+{
+    for (uint16_t col = 0; col < num_factors; col++) {
+        if (value_class[col][row[col]] != row[col]) return false;
+        if (prev_in_class[col] != NO_COLUMN && row[prev_in_class[col]] > row[col]) return false;
+    }
+    return true;
+}
+
+/* HELPER METHOD: random_symmetric_row - maps a canonical row to a random row with the same score
+ *
+ * parameters:
+ * - row: integer array representing the chosen canonical row; overwritten
+ *
+ * returns:
+ * - void, but after the method finishes, row will be a random member of its orbit
+*/
+void Array::random_symmetric_row(uint16_t *row)
+{
+    if (!has_symmetry) return;
+
+    // relabel each value to a random member of its class
+    for (uint16_t col = 0; col < num_factors; col++) {
+        std::vector<uint16_t> members;
+        for (uint16_t value = 0; value < value_class[col].size(); value++)
+            if (value_class[col][value] == value_class[col][row[col]]) members.push_back(value);
+        row[col] = members.at(static_cast<uint64_t>(rand()) % members.size());
+    }
+
+    // shuffle the values among each class of columns (walking each class from its last column back)
+    std::vector<bool> done(num_factors, false);
+    for (uint16_t col = num_factors; col-- > 0;) {
+        if (done[col] || prev_in_class[col] == NO_COLUMN) continue;
+        std::vector<uint16_t> columns;
+        for (uint16_t c = col; c != NO_COLUMN; c = prev_in_class[c]) {
+            columns.push_back(c);
+            done[c] = true;
+        }
+        for (uint64_t i = columns.size() - 1; i > 0; i--)  // Fisher-Yates over the class's values
+            std::swap(row[columns[i]], row[columns.at(static_cast<uint64_t>(rand()) % (i + 1))]);
+    }
+}
@@ -0,0 +1,225 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds property upgrades: asking an Array that already has rows for a stronger property  |
+| (a locating array becoming detecting, a larger d, a larger δ) without building a new Array and replaying |
+| every row through update_array(). The Singles, Interactions, and all coverage state are kept as they are; |
+| T sets are only rebuilt when there were none or d changed, and the deltas are rebuilt for detection. The |
+| location and detection state is then set from the existing rows in one pass, using row bitmaps (as in    |
+| verify.cpp): T sets occurring in the same rows conflict with each other, and each separation is the      |
+| AND-NOT popcount of an Interaction's bitmap against a T set's. The results match what update_scores()    |
+| would have reached one row at a time, so generation simply carries on from there.                       |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include "bitmap.h"
+#include <algorithm>
+#include <string.h>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+/* SUB METHOD: upgrade - switches the Array to new properties, keeping everything the rows already settle
+ * - the caller is responsible for checking that the new d and δ are possible for the factors' levels
+ *  --> see Parser::process_levels()
+ *
+ * parameters:
+ * - new_p: properties wanted from now on; c_only, c_and_l, or all
+ * - new_d: size of the T sets from now on
+ * - new_delta: separation from now on
+ *
+ * returns:
+ * - whether the Array now works towards the new properties (false only when new_p is not one of the above)
+*/
+bool Array::upgrade(prop_mode new_p, uint16_t new_d, uint16_t new_delta)
+{
+    if (new_p != c_only && new_p != c_and_l && new_p != prop_mode::all) return false;
+    if (new_p == p && new_d == d && new_delta == delta) return true;
+    stop_workers();     // their replicas describe the old properties; they are restarted when next needed
+    bool rebuild_sets = new_p == c_only || p == c_only || new_d != d;
+    p = new_p; d = new_d; delta = new_delta;
+
+    // drop whatever the new properties replace
+    for (Interaction *i : interactions) i->deltas.clear();
+    delete delta_file;
+    delta_file = nullptr;
+    delta_matrix = nullptr;
+    if (rebuild_sets) {
+        for (T *t_set : sets) delete t_set;
+        sets.clear();
+        t_set_map.clear();
+        for (Interaction *i : interactions) i->sets.clear();
+        if (p != c_only) build_sets();     // its issue counts are replaced by settle_rows()
+    }
+    settle_rows();
+    if (o != silent)
+        printf("Upgraded to %s with d = %hu and delta = %hu; score is now %llu of %llu.\n",
+            p == c_only ? "covering" : (p == c_and_l ? "locating" : "detecting"), d, delta,
+            static_cast<unsigned long long>(score), static_cast<unsigned long long>(total_problems));
+    return true;
+}
+
+/* HELPER METHOD: settle_rows - sets all location and detection state from the current rows at once
+ * - coverage state is left as it is, as are the rows of the Singles and Interactions, which must be current
+ * - used by upgrade() once the new properties are in place, and by shrink() once it has replaced the rows
+ *
+ * returns:
+ * - void, but after the method finishes, T sets' rows, location and detection state, and the score will
+ *   match what update_scores() would have reached one row at a time
+*/
+void Array::settle_rows()
+{
+    for (Interaction *i : interactions) i->deltas.clear();
+    delete delta_file;
+    delta_file = nullptr;
+    delta_matrix = nullptr;
+    for (uint16_t col = 0; col < num_factors; col++) {
+        factors[col]->l_issues = 0;
+        factors[col]->d_issues = 0;
+        for (uint16_t level = 0; level < factors[col]->level; level++) {
+            factors[col]->singles[level]->l_issues = 0;
+            factors[col]->singles[level]->d_issues = 0;
+        }
+    }
+    location_problems = 0;
+    detection_problems = 0;
+    is_locating = false;
+    is_detecting = false;
+    total_problems = 0;
+    for (Interaction *i : interactions) total_problems += i->singles.size() + 1;
+
+    // the existing rows as bitmaps: Interactions first, then T sets
+    uint64_t words = bitmap_words(num_tests);
+    if (words == 0) words = 1;
+    std::vector<uint64_t> arena((interactions.size() + sets.size())*words, 0);
+    std::vector<uint64_t*> i_bits, t_bits;
+    for (Interaction *i : interactions) {
+        uint64_t *bits = &arena[i_bits.size()*words];
+        for (uint64_t row : i->rows) bits[(row - 1)/64] |= 1ULL << ((row - 1) % 64);  // rows are 1-based
+        i_bits.push_back(bits);
+    }
+    for (T *t_set : sets) {
+        uint64_t *bits = &arena[(interactions.size() + t_bits.size())*words];
+        t_set->rows.clear();
+        for (Interaction *i : t_set->interactions) {
+            or_into(bits, i_bits[i->index], words);
+            t_set->rows.insert(i->rows.begin(), i->rows.end());
+        }
+        t_bits.push_back(bits);
+    }
+    if (p != c_only) upgrade_location(&t_bits, words);
+    if (p == prop_mode::all) upgrade_detection(&i_bits, &t_bits, words);
+
+    // the score is every outstanding issue of every factor, plus every unsolved problem
+    score = coverage_problems + location_problems + detection_problems;
+    for (uint16_t col = 0; col < num_factors; col++)
+        score += factors[col]->c_issues + factors[col]->l_issues + factors[col]->d_issues;
+    for (uint16_t col = 0; col < num_factors; col++) dont_cares[col] = none;
+    update_dont_cares();
+    row_scores.clear();
+    min_positive_score = UINT64_MAX;
+    heuristic_in_use = none;
+    update_heuristic();
+}
+
+/* HELPER METHOD: upgrade_location - sets every T set's location state from the existing rows at once
+ * - T sets that have not occurred conflict with all others; the rest conflict with those in the same rows
+ *
+ * parameters:
+ * - t_bits: row bitmap of every T set, by T::index
+ * - words: length of each bitmap
+ *
+ * returns:
+ * - void, but after the method finishes, location conflicts, issues, and problems will be set
+*/
+void Array::upgrade_location(std::vector<uint64_t*> *t_bits, uint64_t words)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> order;   // (signature, index into sets), for grouping
+    for (T *t_set : sets) {
+        t_set->location_conflicts.clear();
+        t_set->conflicts_with_all = t_set->rows.empty();
+        t_set->is_locatable = false;
+        if (!t_set->conflicts_with_all) order.push_back({bitmap_signature(t_bits->at(t_set->index), words),
+            t_set->index});
+    }
+    std::sort(order.begin(), order.end());
+    for (uint64_t a = 0; a < order.size(); a++)
+        for (uint64_t b = a + 1; b < order.size() && order[b].first == order[a].first; b++) {
+            if (memcmp(t_bits->at(order[a].second), t_bits->at(order[b].second), words*sizeof(uint64_t)) != 0)
+                continue;   // a signature collision, not a conflict
+            sets[order[a].second]->location_conflicts.insert(sets[order[b].second]);
+            sets[order[b].second]->location_conflicts.insert(sets[order[a].second]);
+        }
+    for (T *t_set : sets) {
+        uint64_t issues = t_set->conflicts_with_all ? sets.size() : t_set->location_conflicts.size();
+        for (Single *s : t_set->singles) {
+            factors[s->factor]->l_issues += issues;
+            s->l_issues += issues;
+        }
+        total_problems += t_set->singles.size()*sets.size() + 1;
+        t_set->is_locatable = !t_set->conflicts_with_all && t_set->location_conflicts.empty();
+        if (!t_set->is_locatable) location_problems++;
+    }
+    is_locating = location_problems == 0;
+}
+
+/* HELPER METHOD: upgrade_detection - sets every Interaction's separations from the existing rows at once
+ *
+ * parameters:
+ * - i_bits: row bitmap of every Interaction, by Interaction::index
+ * - t_bits: row bitmap of every T set, by T::index
+ * - words: length of each bitmap
+ *
+ * returns:
+ * - void, but after the method finishes, deltas, detection issues, and problems will be set
+*/
+void Array::upgrade_detection(std::vector<uint64_t*> *i_bits, std::vector<uint64_t*> *t_bits, uint64_t words)
+{
+    uint64_t kept_total = total_problems;
+    build_deltas();     // lays out the deltas (spilling them if need be); its score changes are recomputed below
+    total_problems = kept_total;
+    for (uint16_t col = 0; col < num_factors; col++) {
+        factors[col]->d_issues = 0;
+        for (uint16_t level = 0; level < factors[col]->level; level++)
+            factors[col]->singles[level]->d_issues = 0;
+    }
+    std::vector<uint64_t> separations(sets.size());
+    for (Interaction *i : interactions) {
+        andnot_popcount_batch(i_bits->at(i->index), t_bits->data(), sets.size(), words, separations.data());
+        uint64_t remaining = 0;     // issue units still outstanding for each of the Interaction's Singles
+        i->is_detectable = true;
+        if (delta_matrix) {
+            uint16_t *spilled = spilled_deltas(i);
+            for (uint64_t idx = 0; idx < sets.size(); idx++) {
+                if (spilled[idx] == DELTA_NOT_TRACKED) continue;    // the Interaction is part of this T set
+                spilled[idx] = static_cast<uint16_t>(std::min<uint64_t>(separations[idx], delta + 1));
+                if (separations[idx] < delta) {
+                    i->is_detectable = false;
+                    remaining += delta - separations[idx];
+                }
+            }
+            if (i->is_detectable) delta_file->mark_cold(spilled, sets.size()*sizeof(uint16_t));
+        } else {
+            for (auto &kv : i->deltas) {
+                uint64_t separation = separations[kv.first->index];
+                kv.second = static_cast<uint16_t>(std::min<uint64_t>(separation, DELTA_NOT_TRACKED - 1));
+                if (separation < delta) {
+                    i->is_detectable = false;
+                    remaining += delta - separation;
+                }
+            }
+        }
+        for (Single *s : i->singles) {
+            factors[s->factor]->d_issues += remaining;
+            s->d_issues += remaining;
+        }
+        total_problems += i->singles.size()*delta*(sets.size() - i->sets.size()) + 1;
+        if (!i->is_detectable) detection_problems++;
+    }
+    is_detecting = detection_problems == 0;
+}
@@ -0,0 +1,116 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds verification, which recomputes coverage, location, and detection from scratch     |
+| rather than trusting the incremental bookkeeping in update_scores(). This follows the same checks as      |
+| Isaac Jung's Array-Checker (see README.md), but runs them over row bitmaps using the kernels in bitmap.h: |
+| location sorts T sets by the 64-bit signature of their row bitmaps and only compares bitmaps whose       |
+| signatures collide, and detection computes every |ρ(I) \ ρ(T)| with the batched AND-NOT popcount.       |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include "bitmap.h"
+#include <algorithm>
+#include <string.h>
+#include <unistd.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+/* SUB METHOD: verify - checks all requested properties of the current rows from scratch
+ * - issues are listed when debug mode is on; otherwise only the summary is printed (unless silent)
+ *
+ * returns:
+ * - whether the array has every property requested of it
+*/
+bool Array::verify()
+{
+    uint64_t words = bitmap_words(num_tests);
+    if (words == 0) words = 1;  // keeps every bitmap addressable even with no rows
+
+    // lay out all bitmaps contiguously: Interactions first, then T sets
+    std::vector<uint64_t> arena((interactions.size() + sets.size())*words, 0);
+    std::map<Interaction*, uint64_t*> i_bits;
+    uint64_t offset = 0;
+    for (Interaction *i : interactions) {
+        i_bits.insert({i, &arena[offset]});
+        offset += words;
+    }
+    std::vector<uint16_t> row(num_factors);
+    for (uint64_t r = 0; r < num_tests; r++) {  // from the rows themselves, not the Interactions' row sets
+        std::set<Interaction*> found;
+        rows.copy_row(r, row.data());
+        find_row_interactions(row.data(), &found);
+        for (Interaction *i : found) i_bits.at(i)[r/64] |= 1ULL << (r % 64);
+    }
+    std::vector<uint64_t*> t_bits;
+    for (T *t_set : sets) {
+        uint64_t *bits = &arena[offset];
+        for (Interaction *i : t_set->interactions) or_into(bits, i_bits.at(i), words);
+        t_bits.push_back(bits);
+        offset += words;
+    }
+
+    // coverage: every Interaction occurs somewhere
+    bool covering = true;
+    for (Interaction *i : interactions) {
+        uint64_t *bits = i_bits.at(i);
+        bool occurs = false;
+        for (uint64_t w = 0; w < words && !occurs; w++) occurs = bits[w] != 0;
+        if (occurs) continue;
+        covering = false;
+        if (debug == d_on) printf("==%d== Coverage issue: %s never occurs\n", getpid(), i->to_string().c_str());
+    }
+
+    // location: no two distinct T sets occur in exactly the same rows
+    bool locating = true;
+    if (p != c_only) {
+        std::vector<std::pair<uint64_t, uint64_t>> order;   // (signature, index into sets)
+        for (uint64_t idx = 0; idx < sets.size(); idx++)
+            order.push_back({bitmap_signature(t_bits[idx], words), idx});
+        std::sort(order.begin(), order.end());
+        for (uint64_t a = 0; a < order.size(); a++)
+            for (uint64_t b = a + 1; b < order.size() && order[b].first == order[a].first; b++) {
+                if (memcmp(t_bits[order[a].second], t_bits[order[b].second], words*sizeof(uint64_t)) != 0)
+                    continue;   // a genuine signature collision, not a location issue
+                locating = false;
+                if (debug == d_on) printf("==%d== Location issue: %s and %s occur in the same rows\n", getpid(),
+                    sets[order[a].second]->to_string().c_str(), sets[order[b].second]->to_string().c_str());
+            }
+    }
+
+    // detection: every Interaction is separated by at least δ rows from every T set it is not part of
+    bool detecting = true;
+    uint64_t min_separation = UINT64_MAX;
+    if (p == prop_mode::all) {
+        std::vector<uint64_t> separations(sets.size());
+        for (Interaction *i : interactions) {
+            andnot_popcount_batch(i_bits.at(i), t_bits.data(), sets.size(), words, separations.data());
+            for (uint64_t idx = 0; idx < sets.size(); idx++) {
+                if (i->sets.find(sets[idx]) != i->sets.end()) continue; // the Interaction is part of this T
+                if (separations[idx] < min_separation) min_separation = separations[idx];
+                if (separations[idx] >= delta) continue;
+                detecting = false;
+                if (debug == d_on) printf("==%d== Detection issue: %s is separated from %s by only %llu\n",
+                    getpid(), i->to_string().c_str(), sets[idx]->to_string().c_str(),
+                    static_cast<unsigned long long>(separations[idx]));
+            }
+        }
+    }
+
+    if (o != silent) {
+        printf("\nVerification (%s kernels):\n", bitmap_kernel_name());
+        printf("\t- coverage: %s\n", covering ? "yes" : "no");
+        if (p != c_only) printf("\t- location: %s\n", locating ? "yes" : "no");
+        if (p == prop_mode::all) {
+            printf("\t- detection: %s\n", detecting ? "yes" : "no");
+            if (min_separation != UINT64_MAX)
+                printf("\t- true separation: %llu\n", static_cast<unsigned long long>(min_separation));
+        }
+    }
+    return covering && locating && detecting;
+}
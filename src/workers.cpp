@@ -0,0 +1,312 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/19/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, it holds multi-process scoring for heuristic_all() (--workers). The first time a heavy     |
+| heuristic runs, the Array forks the requested number of worker processes, each connected by a socket     |
+| pair. Forking hands every worker a copy-on-write replica of the Array as it is at that moment; from then |
+| on, every row the coordinator commits is sent to the workers as a short message, and they apply it to    |
+| their replicas, so the replicas never drift. To score, the coordinator sends the base row, the column    |
+| order, and the locked Interaction (if any); every worker enumerates the same candidate rows in the same  |
+| order, scores only the candidates whose ordinal falls in its own partition (using its share of threads), |
+| and sends back its top few. The coordinator merges those and breaks ties randomly, as before. If a      |
+| worker goes away, the coordinator shuts the others down and goes back to scoring in-process.            |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <algorithm>
+#include <string.h>
+#include <sstream>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <Rcpp.h>
+#include <RcppCommon.h>
+
+using namespace Rcpp;
+
+// number of best candidates each worker reports back per scoring request
+#define WORKER_TOP_K 16
+
+// message types; every message is a Message_Header followed by its payload
+#define MESSAGE_ROW     1   // payload: the committed row
+#define MESSAGE_SCORE   2   // payload: locked Interaction index (UINT64_MAX for none), permutation, base row
+#define MESSAGE_RESULT  3   // payload: count, then count (score, row) pairs
+#define MESSAGE_EXIT    4   // no payload
+
+// no locked Interaction
+#define NO_LOCK UINT64_MAX
+
+struct Message_Header
+{
+    uint32_t type;
+    uint32_t length;    // payload bytes
+};
+
+// method forward declarations
+static bool write_all(int fd, const void *data, uint64_t length);
+static bool read_all(int fd, void *data, uint64_t length);
+static bool send_message(int fd, uint32_t type, const std::vector<char> &payload);
+static bool receive_message(int fd, uint32_t *type, std::vector<char> *payload);
+
+/* SUB METHOD: start_workers - forks the worker processes
+ *  --> called lazily, the first time a heavy heuristic runs with --workers greater than 1
+ *
+ * returns:
+ * - whether the workers are running
+*/
+bool Array::start_workers()
+{
+    if (!worker_fds.empty()) return true;
+    if (workers_failed || num_workers < 2) return false;
+    fflush(stdout);     // otherwise anything still buffered would be printed once per process
+    for (uint16_t w = 0; w < num_workers; w++) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) break;
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            break;
+        }
+        if (pid == 0) {     // worker: keep only its own end of its own socket, then serve until told to exit
+            close(fds[0]);
+            for (int fd : worker_fds) close(fd);
+            worker_fds.clear();
+            worker_pids.clear();
+            worker_loop(fds[1], w);
+            _exit(0);
+        }
+        close(fds[1]);
+        worker_fds.push_back(fds[0]);
+        worker_pids.push_back(pid);
+    }
+    if (worker_fds.size() < num_workers) {
+        printf("NOTE: could only start %llu of %hu worker processes; scoring in this process instead\n",
+            static_cast<unsigned long long>(worker_fds.size()), num_workers);
+        stop_workers();
+        workers_failed = true;
+        return false;
+    }
+    if (o != silent) printf("\t- Started %hu worker processes for scoring.\n", num_workers);
+    return true;
+}
+
+/* SUB METHOD: stop_workers - tells the workers to exit and waits for them
+ *
+ * returns:
+ * - void, but after the method finishes, no workers will be running
+*/
+void Array::stop_workers()
+{
+    for (int fd : worker_fds) {
+        send_message(fd, MESSAGE_EXIT, std::vector<char>());
+        close(fd);
+    }
+    for (pid_t pid : worker_pids) waitpid(pid, nullptr, 0);
+    worker_fds.clear();
+    worker_pids.clear();
+}
+
+/* HELPER METHOD: broadcast_row - sends a committed row to every worker so their replicas stay current
+ *
+ * parameters:
+ * - row: the row just added to the array
+ *
+ * returns:
+ * - void, but after the method finishes, every worker will have been sent the row (or all will be stopped)
+*/
+void Array::broadcast_row(uint16_t *row)
+{
+    std::vector<char> payload(reinterpret_cast<char*>(row), reinterpret_cast<char*>(row + num_factors));
+    for (int fd : worker_fds)
+        if (!send_message(fd, MESSAGE_ROW, payload)) {
+            printf("NOTE: lost a worker process; scoring in this process from now on\n");
+            stop_workers();
+            workers_failed = true;
+            return;
+        }
+}
+
+/* SUB METHOD: score_with_workers - the multi-process version of heuristic_all()'s search
+ *
+ * parameters:
+ * - row: integer array representing the base row; overwritten with the chosen row
+ * - locked: pointer to Interaction whose Singles' columns should not be altered; nullptr for none
+ *
+ * returns:
+ * - whether the workers did the scoring; if not, the caller should score in-process
+*/
+bool Array::score_with_workers(uint16_t *row, Interaction *locked)
+{
+    if (!start_workers()) return false;
+    std::vector<char> payload(sizeof(uint64_t) + 2*num_factors*sizeof(uint16_t));
+    uint64_t lock_index = locked ? locked->index : NO_LOCK;
+    memcpy(payload.data(), &lock_index, sizeof(uint64_t));
+    memcpy(payload.data() + sizeof(uint64_t), permutation, num_factors*sizeof(uint16_t));
+    memcpy(payload.data() + sizeof(uint64_t) + num_factors*sizeof(uint16_t), row, num_factors*sizeof(uint16_t));
+    bool lost = false;
+    for (int fd : worker_fds) lost = lost || !send_message(fd, MESSAGE_SCORE, payload);
+
+    // merge every worker's top candidates
+    uint64_t best_score = 0;
+    std::vector<std::vector<uint16_t>> best_rows;   // there could be ties for the best
+    uint64_t entry_bytes = sizeof(uint64_t) + num_factors*sizeof(uint16_t);
+    for (int fd : worker_fds) {
+        uint32_t type;
+        std::vector<char> result;
+        if (lost || !receive_message(fd, &type, &result) || type != MESSAGE_RESULT) {
+            lost = true;
+            continue;
+        }
+        uint64_t count;
+        memcpy(&count, result.data(), sizeof(uint64_t));
+        for (uint64_t e = 0; e < count; e++) {
+            const char *entry = result.data() + sizeof(uint64_t) + e*entry_bytes;
+            uint64_t entry_score;
+            memcpy(&entry_score, entry, sizeof(uint64_t));
+            if (entry_score < best_score) continue;
+            if (entry_score > best_score) {
+                best_score = entry_score;
+                best_rows.clear();
+            }
+            std::vector<uint16_t> candidate(num_factors);
+            memcpy(candidate.data(), entry + sizeof(uint64_t), num_factors*sizeof(uint16_t));
+            best_rows.push_back(candidate);
+        }
+    }
+    if (lost) {
+        printf("NOTE: lost a worker process; scoring in this process from now on\n");
+        stop_workers();
+        workers_failed = true;
+        return false;
+    }
+    if (best_rows.empty()) return false;    // nothing was scored (every candidate was skipped)
+
+    // choose the row that scored the best (for ties, choose randomly from among those tied for the best)
+    std::vector<uint16_t> &choice = best_rows.at(static_cast<uint64_t>(rand()) % best_rows.size());
+    for (uint16_t col = 0; col < num_factors; col++) row[col] = choice[col];
+    return true;
+}
+
+/* HELPER METHOD: worker_loop - body of a worker process
+ *
+ * parameters:
+ * - fd: the worker's end of its socket pair
+ * - index: which partition of the candidates this worker scores
+ *
+ * returns:
+ * - void, once the coordinator says to exit or goes away
+*/
+void Array::worker_loop(int fd, uint16_t index)
+{
+    o = silent; debug = d_off; v = v_off;
+    cancel_token = nullptr;
+    partition_count = num_workers;
+    partition_index = index;
+    max_threads = std::max<uint32_t>(1, max_threads/num_workers);   // share the cores with the other workers
+    heuristic_in_use = none;    // keeps heuristic_all_helper() off the coordinator's memoized scores
+
+    uint32_t type;
+    std::vector<char> payload;
+    while (receive_message(fd, &type, &payload)) {
+        if (type == MESSAGE_EXIT) break;
+        if (type == MESSAGE_ROW) {
+            uint16_t *new_row = new uint16_t[num_factors];
+            memcpy(new_row, payload.data(), num_factors*sizeof(uint16_t));
+            update_array(new_row, true, true);
+            update_dont_cares();
+            continue;
+        }
+        if (type != MESSAGE_SCORE) break;
+
+        uint64_t lock_index;
+        memcpy(&lock_index, payload.data(), sizeof(uint64_t));
+        memcpy(permutation, payload.data() + sizeof(uint64_t), num_factors*sizeof(uint16_t));
+        uint16_t *base = new uint16_t[num_factors];
+        memcpy(base, payload.data() + sizeof(uint64_t) + num_factors*sizeof(uint16_t),
+            num_factors*sizeof(uint16_t));
+        Interaction *locked = lock_index == NO_LOCK ? nullptr : interactions.at(lock_index);
+
+        // score this worker's partition of the candidates
+        find_symmetries(locked);    // the coordinator maps its choice back out of canonical form
+        std::map<std::string, uint64_t> local_scores;
+        std::vector<std::thread*> threads;
+        candidate_ordinal = 0;
+        heuristic_all_helper(base, 0, &threads, locked, &local_scores);
+        for (std::thread *cur_thread : threads) {
+            cur_thread->join();
+            delete cur_thread;
+        }
+        delete[] base;
+
+        // report the top few back
+        std::vector<std::pair<uint64_t, std::string>> ranked;
+        for (auto &kv : local_scores) ranked.push_back({kv.second, kv.first});
+        uint64_t count = std::min<uint64_t>(WORKER_TOP_K, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+            [](const std::pair<uint64_t, std::string> &a, const std::pair<uint64_t, std::string> &b) {
+                return a.first > b.first;
+            });
+        std::vector<char> result(sizeof(uint64_t) + count*(sizeof(uint64_t) + num_factors*sizeof(uint16_t)));
+        memcpy(result.data(), &count, sizeof(uint64_t));
+        char *entry = result.data() + sizeof(uint64_t);
+        for (uint64_t e = 0; e < count; e++) {
+            memcpy(entry, &ranked[e].first, sizeof(uint64_t));
+            std::stringstream row_ss(ranked[e].second);
+            for (uint16_t col = 0; col < num_factors; col++) {
+                uint16_t value;
+                row_ss >> value;
+                memcpy(entry + sizeof(uint64_t) + col*sizeof(uint16_t), &value, sizeof(uint16_t));
+            }
+            entry += sizeof(uint64_t) + num_factors*sizeof(uint16_t);
+        }
+        if (!send_message(fd, MESSAGE_RESULT, result)) break;
+    }
+    close(fd);
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+static bool write_all(int fd, const void *data, uint64_t length)
+{
+    const char *cursor = static_cast<const char*>(data);
+    while (length > 0) {
+        ssize_t written = send(fd, cursor, length, MSG_NOSIGNAL);  // a dead worker is an error, not a signal
+        if (written <= 0) return false;
+        cursor += written;
+        length -= written;
+    }
+    return true;
+}
+
+static bool read_all(int fd, void *data, uint64_t length)
+{
+    char *cursor = static_cast<char*>(data);
+    while (length > 0) {
+        ssize_t got = read(fd, cursor, length);
+        if (got <= 0) return false;
+        cursor += got;
+        length -= got;
+    }
+    return true;
+}
+
+static bool send_message(int fd, uint32_t type, const std::vector<char> &payload)
+{
+    Message_Header header = {type, static_cast<uint32_t>(payload.size())};
+    return write_all(fd, &header, sizeof(header)) && write_all(fd, payload.data(), payload.size());
+}
+
+static bool receive_message(int fd, uint32_t *type, std::vector<char> *payload)
+{
+    Message_Header header;
+    if (!read_all(fd, &header, sizeof(header))) return false;
+    *type = header.type;
+    payload->resize(header.length);
+    return read_all(fd, payload->data(), header.length);
+}